@@ -9,10 +9,23 @@
 
 namespace dacin::geom{
 
+#ifdef HAS_INT128
+template<size_t n>
+using wide_int_backend_t = conditional_t<n <= 127, __int128, Bigint_Fixedsize_Signed<max<size_t>(1, n/64+1), uint64_t> >;
+#else
+template<size_t n>
+using wide_int_backend_t = Bigint_Fixedsize_Signed<max<size_t>(1, n/32+1)>;
+#endif // HAS_INT128
+
 template<size_t n>
 class Adaptive_Int{
 public:
-    using backend_t = conditional_t< n <= 31, int32_t, conditional_t<n <= 63, int64_t, Bigint_Fixedsize_Signed<max<size_t>(1, n/32+1)> > >;
+    using backend_t = conditional_t< n <= 31, int32_t, conditional_t<n <= 63, int64_t, wide_int_backend_t<n> > >;
+#ifdef HAS_INT128
+    static constexpr bool has_native_backend = is_integral_v<backend_t> || is_same_v<backend_t, __int128>;
+#else
+    static constexpr bool has_native_backend = is_integral_v<backend_t>;
+#endif // HAS_INT128
 
     template<typename T>
     struct is_adaptive_int : std::false_type{};
@@ -56,8 +69,8 @@ public:
     }
     template<size_t m, size_t k = n+m>
     Adaptive_Int<k> operator*(Adaptive_Int<m> const&o) const {
-        Adaptive_Int<k> ret(*this);
-        ret*= make_unsafe(o);
+        Adaptive_Int<k> ret;
+        widening_mul(ret.get_value(), value, o.get_cvalue());
         return ret;
     }
     template<size_t m>
@@ -173,11 +186,11 @@ private:
     }
     template<typename T>
     int comp_impl_1(T const&o, std::true_type) const {
-        return value.comp(o.value);
+        return value.comp(o.get_cvalue());
     }
     template<typename T>
     int comp_impl_1(T const&o, std::false_type) const {
-        return (value > o.value) - (value < o.value);
+        return (value > o.get_cvalue()) - (value < o.get_cvalue());
     }
     template<typename T>
     int comp_impl(T const&o, std::false_type) const {
@@ -197,6 +210,31 @@ private:
 template<size_t n>
 class Adaptive_Int<n> Adaptive_Int<n>::ZERO;
 
+/// low 64 bits of the two's complement representation, used as radix sort key
+inline uint64_t low_word(int32_t const&val){
+    return static_cast<uint64_t>(static_cast<int64_t>(val));
+}
+inline uint64_t low_word(int64_t const&val){
+    return static_cast<uint64_t>(val);
+}
+#ifdef HAS_INT128
+inline uint64_t low_word(__int128 const&val){
+    return static_cast<uint64_t>(val);
+}
+#endif // HAS_INT128
+template<size_t word_cnt, typename limb_t, typename T>
+uint64_t low_word(Bigint_Fixedsize_Signed<word_cnt, limb_t, T> const&val){
+    if constexpr(sizeof(limb_t) >= sizeof(uint64_t) || word_cnt == 1){
+        return static_cast<uint64_t>(static_cast<std::make_signed_t<limb_t> >(val.data[0]));
+    } else {
+        return static_cast<uint64_t>(val.data[0]) | static_cast<uint64_t>(val.data[1]) << 32;
+    }
+}
+template<size_t n>
+uint64_t low_word(Adaptive_Int<n> const&val){
+    return low_word(val.get_cvalue());
+}
+
 
 #ifdef DACIN_HASH_HPP
 template<size_t n>
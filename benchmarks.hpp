@@ -0,0 +1,561 @@
+// Released under GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007, see the LICENSE file.
+// Copyright (C) 2018-2019 Daniel Rutschmann aka. dacin21
+
+#undef _GLIBCXX_DEBUG
+
+#include "exact_geometry_all.hpp"
+
+using namespace std;
+
+namespace dacin::geom{
+    /// heap usage, counted by the replacement of the global operator new below
+    struct Allocation_Stats{
+        static inline atomic<size_t> count{0}, current{0}, peak{0};
+        /// starts a new measurement of the peak
+        static void reset_peak(){
+            peak = current.load();
+        }
+    };
+} // namespace dacin::geom
+
+// every block is prefixed by its size, so that operator delete can track the current usage
+// not inlined, as gcc then no longer sees that the malloc and free below match
+constexpr size_t ALLOCATION_HEADER = alignof(max_align_t);
+__attribute__((noinline)) void* operator new(size_t size){
+    using dacin::geom::Allocation_Stats;
+    char* ptr = static_cast<char*>(malloc(size + ALLOCATION_HEADER));
+    if(!ptr) throw bad_alloc();
+    *reinterpret_cast<size_t*>(ptr) = size;
+    ++Allocation_Stats::count;
+    const size_t current = Allocation_Stats::current += size;
+    size_t peak = Allocation_Stats::peak;
+    while(peak < current && !Allocation_Stats::peak.compare_exchange_weak(peak, current));
+    return ptr + ALLOCATION_HEADER;
+}
+__attribute__((noinline)) void operator delete(void* ptr) noexcept{
+    if(!ptr) return;
+    char* block = static_cast<char*>(ptr) - ALLOCATION_HEADER;
+    dacin::geom::Allocation_Stats::current -= *reinterpret_cast<size_t*>(block);
+    free(block);
+}
+void operator delete(void* ptr, size_t) noexcept{
+    operator delete(ptr);
+}
+
+namespace dacin::geom{
+
+    template<typename F>
+    double benchmark_seconds(F&& f){
+        auto const start = chrono::steady_clock::now();
+        f();
+        return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+
+    /// hulls and incircle tests with 63 bit coordinates on bits wide points, returns a hash of the results
+    template<size_t bits>
+    uint64_t threads_workload(uint64_t seed, int ITER){
+        mt19937_64 rng(seed);
+        auto get_rand = [&](){return uniform_int_distribution<int64_t>(0, (int64_t{1}<<62)-1)(rng);};
+        uint64_t ha = 0;
+        for(int it=0;it<ITER;++it){
+            vector<Point<bits> > p(300);
+            for(auto &e:p){
+                e = Point<bits>(get_rand(), get_rand());
+            }
+            ha = ha*12347 + convex_hull(p).size();
+            for(size_t i=0;i+3<p.size();++i){
+                ha = ha*12347 + static_cast<uint32_t>(is_in_circumcircle(p[i], p[i+1], p[i+2], p[i+3]));
+            }
+        }
+        return ha;
+    }
+    /// runs independent workloads on thread_cnt threads, checks them against a sequential run
+    template<size_t bits>
+    void benchmark_threads_impl(){
+        cerr << "Running benchmark benchmark_threads " << bits << "\n";
+        const int ITER = 1000;
+        // at least 4 threads, so that data races show up on small machines too
+        const size_t max_threads = max<size_t>(4, thread::hardware_concurrency());
+        for(size_t thread_cnt = 1;thread_cnt <= max_threads;thread_cnt*=2){
+            vector<uint64_t> expected(thread_cnt), got(thread_cnt);
+            const double t_seq = benchmark_seconds([&](){
+                for(size_t i=0;i<thread_cnt;++i){
+                    expected[i] = threads_workload<bits>(i, ITER);
+                }
+            });
+            const double t_par = benchmark_seconds([&](){
+                vector<thread> threads;
+                for(size_t i=0;i<thread_cnt;++i){
+                    threads.emplace_back([&, i](){got[i] = threads_workload<bits>(i, ITER);});
+                }
+                for(auto &e:threads) e.join();
+            });
+            assert(got == expected);
+            cerr << thread_cnt << " threads: " << thread_cnt * ITER / t_par << " iterations/s, speedup " << t_seq / t_par << "\n";
+        }
+    }
+    void benchmark_threads(){
+        benchmark_threads_impl<100>();
+        benchmark_threads_impl<321>();
+    }
+
+    /// sort_lexicographical against std::sort, coordinates in [-lim, lim]
+    template<size_t bits>
+    void benchmark_sort_lexicographical_impl(size_t N, int64_t lim){
+        cerr << "Running benchmark benchmark_sort_lexicographical " << bits << " " << N << " " << lim << "\n";
+        mt19937_64 rng(N);
+        uniform_int_distribution<int64_t> uniform(-lim, lim);
+        vector<Point<bits> > p(N);
+        for(auto &e:p) e = Point<bits>(uniform(rng), uniform(rng));
+        auto expected = p;
+        const double t_std = benchmark_seconds([&](){
+            std::sort(expected.begin(), expected.end(), [](Point<bits> const&a, Point<bits> const&b){return a.comp_lexicographical(b) < 0;});
+        });
+        const double t_radix = benchmark_seconds([&](){sort_lexicographical(p);});
+        assert(p == expected);
+        cerr << "std::sort " << t_std << " s, radix sort " << t_radix << " s, speedup " << t_std / t_radix << "\n";
+    }
+    void benchmark_sort_lexicographical(){
+        for(size_t N:{1000, 100000, 10000000}){
+            benchmark_sort_lexicographical_impl<30>(N, (1<<29)-1);
+            benchmark_sort_lexicographical_impl<62>(N, (int64_t{1}<<61)-1);
+            benchmark_sort_lexicographical_impl<62>(N, 1000);
+            benchmark_sort_lexicographical_impl<126>(N, (int64_t{1}<<61)-1);
+        }
+    }
+    /// hulls of many small point sets, one convex_hull call per set against convex_hulls with a reused workspace
+    template<size_t bits>
+    void benchmark_convex_hulls_impl(size_t sets, size_t set_size){
+        cerr << "Running benchmark benchmark_convex_hulls " << bits << " " << sets << " " << set_size << "\n";
+        mt19937_64 rng(sets);
+        uniform_int_distribution<int64_t> uniform(-(int64_t{1}<<(bits-2)), int64_t{1}<<(bits-2));
+        vector<Point<bits> > p(sets * set_size);
+        for(auto &e:p) e = Point<bits>(uniform(rng), uniform(rng));
+        vector<size_t> begin;
+        for(size_t i=0;i<=sets;++i) begin.push_back(i * set_size);
+        vector<Point<bits> > expected, hulls;
+        vector<size_t> hull_begin;
+        Convex_Hull_Workspace<bits> ws;
+        const double t_single = benchmark_seconds([&](){
+            expected.clear();
+            for(size_t i=0;i<sets;++i){
+                auto const hull = convex_hull(vector<Point<bits> >(p.begin() + begin[i], p.begin() + begin[i+1]));
+                expected.insert(expected.end(), hull.begin(), hull.end());
+            }
+        });
+        // the first call sizes the buffers
+        convex_hulls(p, begin, hulls, hull_begin, ws);
+        const double t_batch = benchmark_seconds([&](){convex_hulls(p, begin, hulls, hull_begin, ws);});
+        assert(hulls == expected);
+        cerr << "convex_hull " << t_single << " s, convex_hulls " << t_batch << " s, speedup " << t_single / t_batch << "\n";
+    }
+    void benchmark_convex_hulls(){
+        benchmark_convex_hulls_impl<30>(300000, 30);
+        benchmark_convex_hulls_impl<62>(300000, 30);
+        benchmark_convex_hulls_impl<62>(3000, 3000);
+    }
+    /// streamed hull of points generated chunk by chunk, against convex_hull on all of them, with the peak heap usage
+    template<size_t bits>
+    void benchmark_streaming_hull_impl(size_t N, size_t chunk_size){
+        cerr << "Running benchmark benchmark_streaming_hull " << bits << " " << N << " " << chunk_size << "\n";
+        const int64_t lim = (int64_t{1}<<(bits-2)) - 1;
+        auto generate = [&](mt19937_64 &rng, vector<Point<bits> > &p, size_t cnt){
+            uniform_int_distribution<int64_t> uniform(-lim, lim);
+            p.resize(cnt);
+            for(auto &e:p) e = Point<bits>(uniform(rng), uniform(rng));
+        };
+        mt19937_64 rng(N);
+        vector<Point<bits> > p;
+        size_t current_before = Allocation_Stats::current;
+        Allocation_Stats::reset_peak();
+        vector<Point<bits> > expected;
+        const double t_full = benchmark_seconds([&](){
+            generate(rng, p, N);
+            expected = convex_hull(move(p));
+        });
+        const double peak_full = (Allocation_Stats::peak - current_before) / 1e6;
+        rng.seed(N);
+        p.clear();
+        p.shrink_to_fit();
+        current_before = Allocation_Stats::current;
+        Allocation_Stats::reset_peak();
+        vector<Point<bits> > got;
+        const double t_stream = benchmark_seconds([&](){
+            Streaming_Hull<bits> h(chunk_size);
+            for(size_t i=0;i<N;i+=chunk_size){
+                generate(rng, p, min(chunk_size, N-i));
+                h.add(p.begin(), p.end());
+            }
+            got = h.get_hull();
+        });
+        const double peak_stream = (Allocation_Stats::peak - current_before) / 1e6;
+        assert(got == expected);
+        cerr << "convex_hull " << t_full << " s, " << peak_full << " MB peak, streaming " << t_stream << " s, " << peak_stream << " MB peak\n";
+    }
+    void benchmark_streaming_hull(){
+        benchmark_streaming_hull_impl<30>(10000000, 1<<16);
+        benchmark_streaming_hull_impl<62>(10000000, 1<<16);
+        benchmark_streaming_hull_impl<62>(10000000, 1<<10);
+    }
+    /// rotating calipers on a hull with N vertices, against the width from the Minkowski difference of the hull with itself
+    template<size_t bits>
+    void benchmark_rotating_calipers_impl(size_t N){
+        cerr << "Running benchmark benchmark_rotating_calipers " << bits << " " << N << "\n";
+        // points on two parabolas, so that all of them are on the hull
+        const int64_t c = static_cast<int64_t>(N/4) * static_cast<int64_t>(N/4) + 1;
+        vector<Point<bits> > p;
+        for(size_t i=0;i<N/2;++i){
+            const int64_t x = static_cast<int64_t>(i) - static_cast<int64_t>(N/4);
+            p.emplace_back(x, c - x*x);
+            p.emplace_back(x, x*x - c);
+        }
+        const auto hull = convex_hull(p);
+        size_t checksum = 0;
+        const double t_diameter = benchmark_seconds([&](){checksum+= diameter(hull).second[0];});
+        const double t_rectangle = benchmark_seconds([&](){checksum+= min_area_rectangle(hull).second.edge;});
+        double width = 0, width_minkowski = 1e300;
+        const double t_width = benchmark_seconds([&](){width = static_cast<double>(width_sq(hull).first);});
+        const double t_minkowski = benchmark_seconds([&](){
+            vector<Point<bits> > negated;
+            for(auto const&e:hull) negated.emplace_back(-e.x, -e.y);
+            auto diff = minkowski_sum(hull, negated);
+            for(size_t i=0;i<diff.size();++i){
+                auto const&a = diff[i], &b = diff[(i+1)%diff.size()];
+                width_minkowski = min(width_minkowski, static_cast<double>(a.cross(b)) / sqrt(static_cast<double>((b - a).norm_sq())));
+            }
+        });
+        cerr << hull.size() << " vertices, diameter " << t_diameter << " s, min area rectangle " << t_rectangle << " s, width " << t_width << " s, with minkowski_sum " << t_minkowski << " s, relative difference " << abs(sqrt(width) - width_minkowski) / sqrt(width) << ", checksum " << checksum << "\n";
+    }
+    void benchmark_rotating_calipers(){
+        // the parabolas need N^2 / 16 < 2^(bits-2)
+        benchmark_rotating_calipers_impl<30>(60000);
+        benchmark_rotating_calipers_impl<62>(1000000);
+    }
+    /// insert and erase all points of a square and of a parabola, where all points are on the hull
+    template<size_t bits>
+    void benchmark_dynamic_hull_impl(size_t N){
+        cerr << "Running benchmark benchmark_dynamic_hull " << bits << " " << N << "\n";
+        mt19937_64 rng(N);
+        const int64_t lim = (int64_t{1}<<(bits-2)) - 1;
+        vector<Point<bits> > square, parabola;
+        for(size_t i=0;i<N;++i){
+            square.emplace_back(uniform_int_distribution<int64_t>(-lim, lim)(rng), uniform_int_distribution<int64_t>(-lim, lim)(rng));
+            const int64_t x = static_cast<int64_t>(i) - static_cast<int64_t>(N/2);
+            parabola.emplace_back(x, x*x);
+        }
+        shuffle(parabola.begin(), parabola.end(), rng);
+        for(auto const*p:{&square, &parabola}){
+            Dynamic_Hull<bits> h;
+            const double t_insert = benchmark_seconds([&](){for(auto const&e:*p) h.insert(e);});
+            const size_t hull_size = h.get_hull().size();
+            const double t_erase = benchmark_seconds([&](){for(auto const&e:*p) h.erase(e);});
+            const double t_static = benchmark_seconds([&](){convex_hull(*p);});
+            cerr << (p == &square ? "square" : "parabola") << ", " << hull_size << " on hull: insert " << t_insert / N * 1e6 << " us, erase " << t_erase / N * 1e6 << " us, one convex_hull " << t_static * 1e6 << " us\n";
+        }
+    }
+    void benchmark_dynamic_hull(){
+        // the parabola needs N^2 / 4 < 2^(bits-2)
+        benchmark_dynamic_hull_impl<30>(30000);
+        benchmark_dynamic_hull_impl<62>(100000);
+    }
+    /// convex hull with and without the octagon filter, on points in a square, in a gaussian cluster and close to a circle
+    template<size_t bits>
+    void benchmark_convex_hull_filter_impl(size_t N){
+        cerr << "Running benchmark benchmark_convex_hull_filter " << bits << " " << N << "\n";
+        mt19937_64 rng(N);
+        const int64_t lim = (int64_t{1}<<(bits-2)) - 1;
+        uniform_int_distribution<int64_t> uniform(-lim, lim);
+        normal_distribution<double> gauss(0, lim / 8.0);
+        uniform_real_distribution<double> angle(0, 2*acos(-1.0));
+        const array<string, 3> names{"square", "gaussian", "circle"};
+        for(int type=0;type<3;++type){
+            vector<Point<bits> > p(N);
+            for(auto &e:p){
+                if(type == 0) e = Point<bits>(uniform(rng), uniform(rng));
+                else if(type == 1) e = Point<bits>(static_cast<int64_t>(gauss(rng)), static_cast<int64_t>(gauss(rng)));
+                else {
+                    const double a = angle(rng);
+                    e = Point<bits>(static_cast<int64_t>(lim * cos(a)), static_cast<int64_t>(lim * sin(a)));
+                }
+            }
+            vector<Point<bits> > expected, got;
+            const double t_plain = benchmark_seconds([&](){expected = convex_hull(p);});
+            const double t_filter = benchmark_seconds([&](){got = convex_hull(p, Hull_Octagon_Filter{});});
+            assert(got == expected);
+            vector<Point<bits> > q = p;
+            const double discarded = static_cast<double>(octagon_filter(q)) / N;
+            cerr << names[type] << ": plain " << t_plain << " s, filtered " << t_filter << " s, speedup " << t_plain / t_filter << ", " << 100 * discarded << "% discarded\n";
+        }
+    }
+    void benchmark_convex_hull_filter(){
+        benchmark_convex_hull_filter_impl<30>(10000000);
+        benchmark_convex_hull_filter_impl<62>(10000000);
+    }
+    /// convex hull of N random points on 1, 2, 4, ... threads
+    template<size_t bits>
+    void benchmark_convex_hull_parallel_impl(size_t N){
+        cerr << "Running benchmark benchmark_convex_hull_parallel " << bits << " " << N << "\n";
+        mt19937_64 rng(N);
+        const int64_t lim = (int64_t{1}<<(bits-2)) - 1;
+        vector<Point<bits> > p(N);
+        for(auto &e:p) e = Point<bits>(uniform_int_distribution<int64_t>(-lim, lim)(rng), uniform_int_distribution<int64_t>(-lim, lim)(rng));
+        vector<Point<bits> > expected;
+        const double t_seq = benchmark_seconds([&](){expected = convex_hull(p);});
+        cerr << "convex_hull: " << t_seq << " s\n";
+        const size_t max_threads = max<size_t>(4, thread::hardware_concurrency());
+        for(size_t thread_cnt = 2;thread_cnt <= max_threads;thread_cnt*=2){
+            vector<Point<bits> > got;
+            const double t = benchmark_seconds([&](){got = convex_hull_parallel(p, thread_cnt);});
+            assert(got == expected);
+            cerr << thread_cnt << " threads: " << t << " s, speedup " << t_seq / t << "\n";
+        }
+    }
+    void benchmark_convex_hull_parallel(){
+        benchmark_convex_hull_parallel_impl<30>(10000000);
+        benchmark_convex_hull_parallel_impl<62>(10000000);
+    }
+
+    /// seconds per product of two n word numbers with the given kernel
+    template<size_t n, typename limb_t, typename Kernel>
+    double benchmark_mul_kernel(){
+        using Big = Bigint_Fixedsize_Signed<2*n, limb_t>;
+        mt19937_64 rng(n);
+        const int ITER = max<int>(1000, 4000000 / (n*n));
+        array<limb_t, n> a, b;
+        array<limb_t, 2*n> c{};
+        for(auto &e:a) e = static_cast<limb_t>(rng());
+        for(auto &e:b) e = static_cast<limb_t>(rng());
+        const double t = benchmark_seconds([&](){
+            for(int it=0;it<ITER;++it){
+                Big::mul_unsigned(c, a, b, Kernel{});
+                // feed the result back, so that the loop can't be hoisted
+                a[0]^= c[n];
+            }
+        });
+        return t / ITER;
+    }
+    /// compares schoolbook and single level Karatsuba on n word products, to tune DACIN_KARATSUBA_THRESHOLD
+    template<typename limb_t, size_t... n>
+    void benchmark_karatsuba_impl(std::index_sequence<n...>){
+        cerr << "Running benchmark benchmark_karatsuba " << 8*sizeof(limb_t) << "\n";
+        size_t crossover = 0;
+        auto run = [&](size_t words, double t_school, double t_kara){
+            cerr << words << " words: schoolbook " << t_school*1e9 << " ns, karatsuba " << t_kara*1e9 << " ns\n";
+            if(!crossover && t_kara < t_school) crossover = words;
+        };
+        (run(n, benchmark_mul_kernel<n, limb_t, Mul_Schoolbook>(), benchmark_mul_kernel<n, limb_t, Mul_Karatsuba>()), ...);
+        cerr << "crossover at " << crossover << " words, DACIN_KARATSUBA_THRESHOLD is " << DACIN_KARATSUBA_THRESHOLD << "\n";
+    }
+    void benchmark_karatsuba(){
+        using Sizes = std::index_sequence<8, 16, 24, 32, 48, 64, 96, 128>;
+        benchmark_karatsuba_impl<uint32_t>(Sizes{});
+        #ifdef HAS_INT128
+        benchmark_karatsuba_impl<uint64_t>(Sizes{});
+        #endif // HAS_INT128
+    }
+
+    /// triangulates N points given in sorted order, on a grid and in random order
+    template<size_t bits>
+    void benchmark_delaunay_impl(size_t N, vector<Insertion_Order> const&orders){
+        cerr << "Running benchmark benchmark_delaunay " << bits << " " << N << "\n";
+        mt19937_64 rng(N);
+        const int64_t lim = (int64_t{1}<<(bits-2)) - 1;
+        vector<pair<string, vector<Point<bits> > > > inputs(3);
+        inputs[0].first = "sorted";
+        inputs[1].first = "grid";
+        inputs[2].first = "random";
+        set<pair<int64_t, int64_t> > distinct;
+        while(distinct.size() < N){
+            distinct.emplace(uniform_int_distribution<int64_t>(-lim, lim)(rng), uniform_int_distribution<int64_t>(-lim, lim)(rng));
+        }
+        for(auto const&e:distinct){
+            inputs[0].second.emplace_back(e.first, e.second);
+        }
+        const int64_t side = ceil(sqrt(N));
+        for(size_t i=0;i<N;++i){
+            inputs[1].second.emplace_back(static_cast<int64_t>(i)/side, static_cast<int64_t>(i)%side);
+        }
+        inputs[2].second = inputs[0].second;
+        shuffle(inputs[2].second.begin(), inputs[2].second.end(), rng);
+        const array<string, 4> names{"input", "random", "hilbert", "brio"};
+        for(auto const&input:inputs){
+            for(auto const&order:orders){
+                Delaunay<bits> d;
+                size_t faces = 0;
+                const size_t count_before = Allocation_Stats::count, current_before = Allocation_Stats::current;
+                Allocation_Stats::reset_peak();
+                const double t = benchmark_seconds([&](){faces = d.triangulate(input.second, order).size();});
+                cerr << input.first << " " << names[static_cast<int>(order)] << ": " << t << " s, " << t * 1e9 / (N * log2(N)) << " ns / (n log n), " << faces << " faces, "
+                     << Allocation_Stats::count - count_before << " allocations, " << (Allocation_Stats::peak - current_before) / 1e6 << " MB peak\n";
+            }
+        }
+        Delaunay<bits> d;
+        const size_t face_bytes = d.triangulate(inputs[2].second).size() * sizeof(typename Delaunay<bits>::Face);
+        const Delaunay_Mesh mesh = d.get_mesh();
+        const size_t mesh_bytes = mesh.triangles.size() * sizeof(mesh.triangles[0]) + mesh.neighbors.size() * sizeof(mesh.neighbors[0]);
+        cerr << "output: faces " << face_bytes / 1e6 << " MB, mesh " << mesh_bytes / 1e6 << " MB\n";
+    }
+    /// moves points of a triangulation by a removal and an insertion, compared to a rebuild
+    template<size_t bits>
+    void benchmark_delaunay_online_impl(size_t N){
+        cerr << "Running benchmark benchmark_delaunay_online " << bits << " " << N << "\n";
+        mt19937_64 rng(N);
+        const int64_t lim = (int64_t{1}<<(bits-2)) - 1;
+        auto get_rand = [&](int64_t l, int64_t r){return uniform_int_distribution<int64_t>(l, r)(rng);};
+        vector<pair<int64_t, int64_t> > coords(N);
+        vector<Point<bits> > p;
+        for(auto &e:coords){
+            e = {get_rand(-lim, lim), get_rand(-lim, lim)};
+            p.emplace_back(e.first, e.second);
+        }
+        Delaunay<bits> d;
+        const double t_build = benchmark_seconds([&](){d.triangulate(p);});
+        vector<int> vertices(N);
+        iota(vertices.begin(), vertices.end(), 0);
+        const size_t UPDATES = N;
+        const int64_t step = lim / static_cast<int64_t>(sqrt(N));
+        const double t_update = benchmark_seconds([&](){
+            for(size_t it=0;it<UPDATES;++it){
+                const size_t i = get_rand(0, N-1);
+                coords[i].first = clamp(coords[i].first + get_rand(-step, step), -lim, lim);
+                coords[i].second = clamp(coords[i].second + get_rand(-step, step), -lim, lim);
+                d.remove(vertices[i]);
+                vertices[i] = d.insert(Point<bits>(coords[i].first, coords[i].second));
+            }
+        });
+        cerr << "rebuild: " << t_build << " s, update: " << t_update * 1e9 / UPDATES << " ns, " << t_build / (t_update / UPDATES) << " updates per rebuild\n";
+    }
+    /// repairs a triangulation after moving every point by up to step, compared to a rebuild
+    template<size_t bits>
+    void benchmark_delaunay_move_impl(size_t N, int64_t step){
+        cerr << "Running benchmark benchmark_delaunay_move " << bits << " " << N << " " << step << "\n";
+        mt19937_64 rng(N);
+        const int64_t lim = (int64_t{1}<<(bits-3)) - 1;
+        auto get_rand = [&](int64_t l, int64_t r){return uniform_int_distribution<int64_t>(l, r)(rng);};
+        set<pair<int64_t, int64_t> > distinct;
+        while(distinct.size() < N) distinct.emplace(get_rand(-lim, lim), get_rand(-lim, lim));
+        vector<pair<int64_t, int64_t> > coords(distinct.begin(), distinct.end());
+        vector<Point<bits> > p;
+        for(auto const&e:coords) p.emplace_back(e.first, e.second);
+        Delaunay<bits> d;
+        d.triangulate(p);
+        const int ROUNDS = 5;
+        double t_move = 0, t_build = 0;
+        Delaunay_Repair_Stats stats;
+        for(int round=0;round<ROUNDS;++round){
+            // moved points may coincide in theory, but not for these sizes in practice
+            for(size_t i=0;i<N;++i){
+                coords[i].first+= get_rand(-step, step);
+                coords[i].second+= get_rand(-step, step);
+                p[i] = Point<bits>(coords[i].first, coords[i].second);
+            }
+            t_move+= benchmark_seconds([&](){
+                const Delaunay_Repair_Stats s = d.move_points(p);
+                stats.flips+= s.flips;
+                stats.reinserted+= s.reinserted;
+            });
+            t_build+= benchmark_seconds([&](){Delaunay<bits>().triangulate_mesh(p);});
+        }
+        cerr << "move_points: " << t_move / ROUNDS << " s, " << stats.flips / ROUNDS << " flips, " << stats.reinserted / ROUNDS << " reinserted, rebuild: " << t_build / ROUNDS << " s\n";
+    }
+    /// minimum spanning tree and nearest neighbors of N random points, on top of the triangulation
+    template<size_t bits>
+    void benchmark_delaunay_graphs_impl(size_t N){
+        cerr << "Running benchmark benchmark_delaunay_graphs " << bits << " " << N << "\n";
+        mt19937_64 rng(N);
+        const int64_t lim = (int64_t{1}<<(bits-2)) - 1;
+        set<pair<int64_t, int64_t> > distinct;
+        while(distinct.size() < N){
+            distinct.emplace(uniform_int_distribution<int64_t>(-lim, lim)(rng), uniform_int_distribution<int64_t>(-lim, lim)(rng));
+        }
+        vector<Point<bits> > p;
+        for(auto const&e:distinct) p.emplace_back(e.first, e.second);
+        Delaunay<bits> d;
+        const double t_delaunay = benchmark_seconds([&](){d.triangulate(p);});
+        size_t tree_size = 0;
+        const double t_mst = benchmark_seconds([&](){tree_size = euclidean_mst(d).size();});
+        const double t_nearest = benchmark_seconds([&](){nearest_neighbors(d);});
+        assert(tree_size == N-1);
+        cerr << "triangulate: " << t_delaunay << " s, mst: " << t_mst << " s, nearest neighbors: " << t_nearest << " s\n";
+    }
+    /// Voronoi diagram of N random points, on top of the triangulation
+    template<size_t bits>
+    void benchmark_voronoi_impl(size_t N){
+        cerr << "Running benchmark benchmark_voronoi " << bits << " " << N << "\n";
+        mt19937_64 rng(N);
+        const int64_t lim = (int64_t{1}<<(bits-2)) - 1;
+        set<pair<int64_t, int64_t> > distinct;
+        while(distinct.size() < N){
+            distinct.emplace(uniform_int_distribution<int64_t>(-lim, lim)(rng), uniform_int_distribution<int64_t>(-lim, lim)(rng));
+        }
+        vector<Point<bits> > p;
+        for(auto const&e:distinct) p.emplace_back(e.first, e.second);
+        Delaunay<bits> d;
+        const double t_delaunay = benchmark_seconds([&](){d.triangulate(p);});
+        size_t vertices = 0;
+        const double t_voronoi = benchmark_seconds([&](){vertices = voronoi_diagram(d).vertices.size();});
+        cerr << "triangulate: " << t_delaunay << " s, voronoi: " << t_voronoi << " s, " << vertices << " vertices of " << sizeof(typename Voronoi_Diagram<bits>::vertex_t) << " bytes\n";
+    }
+    /// divide and conquer on 1, 2, 4, ... threads, compared to the incremental algorithm
+    template<size_t bits>
+    void benchmark_delaunay_divide_conquer_impl(size_t N){
+        cerr << "Running benchmark benchmark_delaunay_divide_conquer " << bits << " " << N << "\n";
+        mt19937_64 rng(N);
+        const int64_t lim = (int64_t{1}<<(bits-2)) - 1;
+        set<pair<int64_t, int64_t> > distinct;
+        while(distinct.size() < N){
+            distinct.emplace(uniform_int_distribution<int64_t>(-lim, lim)(rng), uniform_int_distribution<int64_t>(-lim, lim)(rng));
+        }
+        vector<Point<bits> > p;
+        for(auto const&e:distinct) p.emplace_back(e.first, e.second);
+        shuffle(p.begin(), p.end(), rng);
+        size_t expected = 0;
+        const double t_incremental = benchmark_seconds([&](){expected = Delaunay<bits>().triangulate_mesh(p).triangles.size();});
+        cerr << "incremental: " << t_incremental << " s\n";
+        const size_t max_threads = max<size_t>(4, thread::hardware_concurrency());
+        double t_one = 0;
+        for(size_t thread_cnt = 1;thread_cnt <= max_threads;thread_cnt*=2){
+            size_t got = 0;
+            const double t = benchmark_seconds([&](){got = Delaunay_Divide_Conquer<bits>().triangulate(p, thread_cnt).triangles.size();});
+            assert(got == expected);
+            if(thread_cnt == 1) t_one = t;
+            cerr << thread_cnt << " threads: " << t << " s, speedup " << t_one / t << ", " << t_incremental / t << " over incremental\n";
+        }
+    }
+    void benchmark_delaunay(){
+        // inserting sorted input in the given order is quadratic
+        benchmark_delaunay_impl<30>(10000, {Insertion_Order::INPUT, Insertion_Order::RANDOM, Insertion_Order::HILBERT, Insertion_Order::BRIO});
+        benchmark_delaunay_impl<30>(100000, {Insertion_Order::RANDOM, Insertion_Order::HILBERT, Insertion_Order::BRIO});
+        benchmark_delaunay_impl<62>(100000, {Insertion_Order::RANDOM, Insertion_Order::BRIO});
+        benchmark_delaunay_online_impl<30>(10000);
+        benchmark_delaunay_online_impl<30>(1000000);
+        benchmark_delaunay_move_impl<30>(1000000, 0);
+        benchmark_delaunay_move_impl<30>(1000000, 1<<8);
+        benchmark_delaunay_move_impl<30>(1000000, 1<<12);
+        benchmark_delaunay_graphs_impl<30>(1000000);
+        benchmark_delaunay_graphs_impl<62>(1000000);
+        benchmark_voronoi_impl<30>(1000000);
+        benchmark_voronoi_impl<62>(1000000);
+        benchmark_delaunay_divide_conquer_impl<30>(1000000);
+        benchmark_delaunay_divide_conquer_impl<62>(1000000);
+    }
+
+} // namespace dacin::geom
+
+
+
+void run_benchmarks(){
+    cerr << "Running all benchmarks\n";
+    dacin::geom::benchmark_threads();
+    dacin::geom::benchmark_sort_lexicographical();
+    dacin::geom::benchmark_convex_hull_filter();
+    dacin::geom::benchmark_convex_hulls();
+    dacin::geom::benchmark_dynamic_hull();
+    dacin::geom::benchmark_streaming_hull();
+    dacin::geom::benchmark_rotating_calipers();
+    dacin::geom::benchmark_convex_hull_parallel();
+    dacin::geom::benchmark_karatsuba();
+    dacin::geom::benchmark_delaunay();
+
+    cerr << "Done with all benchmarks\n";
+}
@@ -8,17 +8,55 @@
 
 namespace dacin::geom{
 
-template<size_t word_cnt, typename = enable_if_t<word_cnt != 0> >
+#ifdef HAS_INT128
+using widest_unsigned_t = unsigned __int128;
+#else
+using widest_unsigned_t = uint64_t;
+#endif // HAS_INT128
+
+/// double width type used for carries
+template<typename limb_t>
+struct Bigint_Limb_Traits{};
+template<>
+struct Bigint_Limb_Traits<uint32_t>{
+    using wide_t = uint64_t;
+};
+#ifdef HAS_INT128
+template<>
+struct Bigint_Limb_Traits<uint64_t>{
+    using wide_t = unsigned __int128;
+};
+#endif // HAS_INT128
+
+#ifndef DACIN_KARATSUBA_THRESHOLD
+/// operands with at least this many words are multiplied with Karatsuba, see benchmark_karatsuba
+#define DACIN_KARATSUBA_THRESHOLD 32
+#endif // DACIN_KARATSUBA_THRESHOLD
+
+/// multiplication kernels, selected at compile time from the word counts
+struct Mul_Schoolbook{};
+struct Mul_Unrolled{};
+struct Mul_Karatsuba{};
+
+/**
+ *  Fixed size two's complement integer with word_cnt limbs of type limb_t.
+ *
+ *  limb_t is uint32_t or, if unsigned __int128 is available for the carries, uint64_t.
+ */
+template<size_t word_cnt, typename limb_t = uint32_t, typename = enable_if_t<word_cnt != 0> >
 class Bigint_Fixedsize_Signed{
 public:
-    std::array<uint32_t, word_cnt> data;
+    using wide_t = typename Bigint_Limb_Traits<limb_t>::wide_t;
+    static constexpr size_t LIMB_BITS = 8 * sizeof(limb_t);
+
+    std::array<limb_t, word_cnt> data;
 
     template<typename T>
     using is_compatible_with = integral_constant<bool, is_integral_v<T> && (sizeof(T) >= 4)>;
     template<typename T>
     struct is_bigint : std::false_type{};
-    template<size_t other_word_cnt, typename T>
-    struct is_bigint<Bigint_Fixedsize_Signed<other_word_cnt, T> > : std::true_type{};
+    template<size_t other_word_cnt, typename other_limb_t, typename T>
+    struct is_bigint<Bigint_Fixedsize_Signed<other_word_cnt, other_limb_t, T> > : std::true_type{};
     template<typename T>
     using enable_if_by_construction_t = enable_if_t<is_constructible_v<Bigint_Fixedsize_Signed, T> && !is_bigint<decay_t<T> >::value>;
 
@@ -35,20 +73,39 @@ private:
     template<typename T>
     T convert_to_floating() const {
         static_assert(std::is_floating_point<T>::value);
+        const T base = static_cast<T>(limb_t{1} << (LIMB_BITS-1)) * 2;
         if(is_negative()){
             T ret = 0;
             for(auto it = data.rbegin(), it_end = data.rend();it!=it_end;++it){
-                ret = (ret * (1ull<< 32)) - ~*it;
+                ret = (ret * base) - static_cast<limb_t>(~*it);
             }
             return ret - 1;
         } else {
             T ret = 0;
             for(auto it = data.rbegin(), it_end = data.rend();it!=it_end;++it){
-                ret = (ret * (1ull<< 32)) + *it;
+                ret = (ret * base) + *it;
             }
             return ret;
         }
     }
+    /// sign extends or truncates val into data
+    template<typename T>
+    void assign_integral(T const&val){
+        // at least as wide as a limb, so that the conversion sign extends
+        using unsigned_t = conditional_t<(sizeof(T) > sizeof(uint64_t)), widest_unsigned_t, conditional_t<(sizeof(T) > sizeof(limb_t)), uint64_t, limb_t> >;
+        constexpr size_t used = sizeof(unsigned_t) / sizeof(limb_t);
+        constexpr bool is_signed = T(-1) < T(0);
+        unsigned_t tmp = static_cast<unsigned_t>(val);
+        for(size_t i=0;i<used && i<word_cnt;++i){
+            data[i] = static_cast<limb_t>(tmp);
+            // two shifts, as shifting by the full width of unsigned_t is undefined
+            tmp>>= LIMB_BITS/2;
+            tmp>>= LIMB_BITS/2;
+        }
+        if(is_signed && val < T(0)){
+            for(size_t i=used;i<word_cnt;++i) data[i] = ~limb_t{};
+        }
+    }
 
     Bigint_Fixedsize_Signed& impl_mul_inplace(int32_t const&val, std::true_type){
         uint32_t res = val;
@@ -59,16 +116,16 @@ private:
         return operator*=(res);
     }
     Bigint_Fixedsize_Signed& impl_mul_inplace(uint32_t const&o, std::true_type){
-        size_t carry = 0;
+        wide_t carry = 0;
         for(auto &e:data){
-            carry+= e*static_cast<uint64_t>(o);
+            carry+= e*static_cast<wide_t>(o);
             e = carry;
-            carry>>=32;
+            carry>>=LIMB_BITS;
         }
         return *this;
     }
     template<size_t other_word_cnt>
-    Bigint_Fixedsize_Signed& impl_mul_inplace(Bigint_Fixedsize_Signed<other_word_cnt> const&o, std::false_type){
+    Bigint_Fixedsize_Signed& impl_mul_inplace(Bigint_Fixedsize_Signed<other_word_cnt, limb_t> const&o, std::false_type){
         static_assert(other_word_cnt <= word_cnt);
         mul(data, data, o.data);
         return *this;
@@ -85,14 +142,14 @@ private:
 
 
     template<size_t n, typename = enable_if_t<n!=0> >
-    static uint32_t get_pad(std::array<uint32_t, n> const&a){
-        return -(a.back()>>31);
+    static limb_t get_pad(std::array<limb_t, n> const&a){
+        return -(a.back()>>(LIMB_BITS-1));
     }
     template<size_t n1, size_t n2>
-    static int signed_comp(std::array<uint32_t, n1> const&a, std::array<uint32_t, n2> const&b){
-        const uint32_t pad_a = get_pad(a), pad_b = get_pad(b);
+    static int signed_comp(std::array<limb_t, n1> const&a, std::array<limb_t, n2> const&b){
+        const limb_t pad_a = get_pad(a), pad_b = get_pad(b);
         if(pad_a != pad_b){
-            return pad_a - pad_b;
+            return pad_a ? -1 : 1;
         }
         size_t j = max(n2, n1)-1;
         for(;j>=n2;--j){
@@ -108,46 +165,44 @@ private:
     }
 
     template<size_t n1, size_t n2, typename = enable_if_t<n2 <= n1> >
-    static void add(std::array<uint32_t, n1> &a, std::array<uint32_t, n2> const&b){
-        uint64_t carry = 0;
+    static void add(std::array<limb_t, n1> &a, std::array<limb_t, n2> const&b){
+        wide_t carry = 0;
         for(size_t i=0;i<n2;++i){
             carry += a[i];
             carry += b[i];
             a[i] = carry;
-            carry >>=32;
+            carry >>=LIMB_BITS;
         }
-        const uint32_t pad_b = get_pad(b);
+        const limb_t pad_b = get_pad(b);
         for(size_t i=n2;i<n1;++i){
             carry += a[i];
             carry += pad_b;
             a[i] = carry;
-            carry>>=32;
+            carry>>=LIMB_BITS;
         }
     }
     template<size_t n1, size_t n2, typename = enable_if_t<n2 <= n1> >
-    static void sub(std::array<uint32_t, n1> &a, std::array<uint32_t, n2> const&b){
-        uint64_t carry = 0;
+    static void sub(std::array<limb_t, n1> &a, std::array<limb_t, n2> const&b){
+        limb_t borrow = 0;
         for(size_t i=0;i<n2;++i){
-            carry += a[i];
-            carry -= b[i];
-            a[i] = carry;
-            carry >>=32;
-            if(carry>>31) carry|=~0ull<<32;
+            const wide_t diff = static_cast<wide_t>(a[i]) - b[i] - borrow;
+            a[i] = diff;
+            borrow = (diff >> LIMB_BITS) & 1;
         }
+        const limb_t pad_b = get_pad(b);
         for(size_t i=n2;i<n1;++i){
-            carry+=a[i];
-            a[i] = carry;
-            carry>>=32;
-            if(carry>>31) carry|=~0ull<<32;
+            const wide_t diff = static_cast<wide_t>(a[i]) - pad_b - borrow;
+            a[i] = diff;
+            borrow = (diff >> LIMB_BITS) & 1;
         }
     }
 
     template<size_t n>
-    static void right_shift_small(std::array<uint32_t, n> &a, size_t const&c){
+    static void right_shift_small(std::array<limb_t, n> &a, size_t const&c){
         if(!c) return;
-        uint32_t carry = get_pad(a), tmp;
+        limb_t carry = get_pad(a), tmp;
         for(size_t i=n-1;i+1;--i){
-            carry<<=32-c;
+            carry<<=LIMB_BITS-c;
             tmp = a[i];
             a[i]>>=c;
             a[i]|=carry;
@@ -155,18 +210,19 @@ private:
         }
     }
     template<size_t n>
-    static void right_shift(std::array<uint32_t, n> &a, size_t c){
-        right_shift_small(a, c%32);
-        c/=32;
-        copy(a.begin()+c, a.end(), a.begin());
-        fill(a.end()-c, a.end(), 0);
+    static void right_shift(std::array<limb_t, n> &a, size_t c){
+        right_shift_small(a, c%LIMB_BITS);
+        c/=LIMB_BITS;
+        const limb_t pad = get_pad(a);
+        std::copy(a.begin()+c, a.end(), a.begin());
+        std::fill(a.end()-c, a.end(), pad);
     }
     template<size_t n>
-    static void left_shift_small(std::array<uint32_t, n> &a, size_t const&c){
+    static void left_shift_small(std::array<limb_t, n> &a, size_t const&c){
         if(!c) return;
-        uint32_t carry = 0, tmp;
-        for(size_t i=0;i<n;--i){
-            carry>>=32-c;
+        limb_t carry = 0, tmp;
+        for(size_t i=0;i<n;++i){
+            carry>>=LIMB_BITS-c;
             tmp = a[i];
             a[i]<<=c;
             a[i]|=carry;
@@ -174,41 +230,68 @@ private:
         }
     }
     template<size_t n>
-    static void left_shift(std::array<uint32_t, n> &a, size_t c){
-        left_shift_small(a, c%32);
-        c/=32;
-        const uint32_t pad = get_pad(a);
-        copy(a.begin(), a.end()-c, a.begin()+c);
-        fill(a.begin(), a.begin()+c, pad);
+    static void left_shift(std::array<limb_t, n> &a, size_t c){
+        left_shift_small(a, c%LIMB_BITS);
+        c/=LIMB_BITS;
+        std::copy_backward(a.begin(), a.end()-c, a.end());
+        std::fill(a.begin(), a.begin()+c, 0);
     }
 
+    /// low n words of a*b, out may alias a
     template<size_t n, size_t m>
-    static void mul(std::array<uint32_t, n>&out, std::array<uint32_t, n> const&a, std::array<uint32_t, m> const&b){
-        static std::array<uint32_t, n + max(n, m) + 1> tmp;
-        std::fill(tmp.begin(), tmp.end(), 0);
-        const uint32_t pad_b = get_pad(b);
-        for(size_t i=0;i<n;++i){
-            uint64_t carry = 0;
-            for(size_t j=0;j<m;++j){
-                carry+=a[i] * static_cast<uint64_t>(b[j]);
-                carry+=tmp[i+j];
-                tmp[i+j] = carry;
-                carry>>=32;
-            }
-            if(m<n && pad_b){
-                for(size_t j=m;j<n;++j){
-                    carry+=a[i] * static_cast<uint64_t>(pad_b);
-                    carry+=tmp[i+j];
-                    tmp[i+j] = carry;
-                    carry>>=32;
-                }
-                tmp[i+n] = carry;
-            } else {
-                tmp[i+m] = carry;
-            }
+    static void mul(std::array<limb_t, n>&out, std::array<limb_t, n> const&a, std::array<limb_t, m> const&b){
+        // scratch on the stack, so that concurrent products don't share state
+        std::array<limb_t, n> tmp;
+        mul_wide(tmp, a, b);
+        out = tmp;
+    }
+    /// out -= b * 2^(s*LIMB_BITS), with b read as unsigned, returns the borrow
+    template<size_t s, size_t k, size_t m>
+    static bool sub_shifted(std::array<limb_t, k>&out, std::array<limb_t, m> const&b){
+        limb_t borrow = 0;
+        size_t i = s;
+        for(;i<min(k, s+m);++i){
+            const wide_t diff = static_cast<wide_t>(out[i]) - b[i-s] - borrow;
+            out[i] = diff;
+            borrow = (diff >> LIMB_BITS) & 1;
+        }
+        for(;borrow && i<k;++i){
+            borrow = !out[i]--;
+        }
+        return borrow;
+    }
+    /// out += b * 2^(s*LIMB_BITS), with b read as unsigned
+    template<size_t s, size_t k, size_t m>
+    static void add_shifted(std::array<limb_t, k>&out, std::array<limb_t, m> const&b){
+        wide_t carry = 0;
+        size_t i = s;
+        for(;i<min(k, s+m);++i){
+            carry+=out[i];
+            carry+=b[i-s];
+            out[i] = carry;
+            carry>>=LIMB_BITS;
+        }
+        for(;carry && i<k;++i){
+            carry = !++out[i];
         }
-        std::copy(tmp.begin(), tmp.begin()+n, out.begin());
     }
+    /// words [off, off+len) of a, zero extended
+    template<size_t off, size_t len, size_t n>
+    static std::array<limb_t, len> slice(std::array<limb_t, n> const&a){
+        std::array<limb_t, len> ret{};
+        for(size_t i=0;i<len && off+i<n;++i) ret[i] = a[off+i];
+        return ret;
+    }
+    /// out = |a - b| for unsigned a and b, returns whether a < b
+    template<size_t n, size_t m>
+    static bool abs_diff(std::array<limb_t, n>&out, std::array<limb_t, n> const&a, std::array<limb_t, m> const&b){
+        out = a;
+        if(!sub_shifted<0>(out, b)) return false;
+        for(auto &e:out) e = ~e;
+        for(size_t i=0;i<n && !++out[i];++i);
+        return true;
+    }
+
     static uint32_t divmod(Bigint_Fixedsize_Signed &a, uint32_t const&d){
         bool nega = false;
         if(a.is_negative()){
@@ -216,9 +299,9 @@ private:
             nega = true;
         }
         assert(d != 0);
-        uint64_t carry = 0;
+        wide_t carry = 0;
         for(size_t i = word_cnt-1;i+1;--i){
-            carry<<=32;
+            carry<<=LIMB_BITS;
             carry += a.data[i];
             a.data[i] = carry / d;
             carry = carry % d;
@@ -241,8 +324,89 @@ private:
     }
 
 public:
+    /// products with at most this many limb multiplications are fully unrolled
+    static constexpr size_t MUL_UNROLL_LIMIT = 64;
+
+    /// kernel for the low k words of a n times m word product
+    template<size_t k, size_t n, size_t m>
+    using mul_kernel_t = conditional_t<(min(n, m) >= DACIN_KARATSUBA_THRESHOLD), Mul_Karatsuba,
+                         conditional_t<(min(n, k) * m <= MUL_UNROLL_LIMIT), Mul_Unrolled, Mul_Schoolbook> >;
+
+    /// low k words of the unsigned product, fully unrolled
+    template<size_t k, size_t n, size_t m>
+    static void mul_unsigned(std::array<limb_t, k>&out, std::array<limb_t, n> const&a, std::array<limb_t, m> const&b, Mul_Unrolled){
+        out.fill(0);
+        static_for<min(n, k)>([&](auto i_){
+            constexpr size_t i = decltype(i_)::value;
+            wide_t carry = 0;
+            static_for<min(m, k-i)>([&](auto j_){
+                constexpr size_t j = decltype(j_)::value;
+                carry+=a[i] * static_cast<wide_t>(b[j]);
+                carry+=out[i+j];
+                out[i+j] = carry;
+                carry>>=LIMB_BITS;
+            });
+            if constexpr(i+m < k) out[i+m] = carry;
+        });
+    }
+    /// low k words of the unsigned product
+    template<size_t k, size_t n, size_t m>
+    static void mul_unsigned(std::array<limb_t, k>&out, std::array<limb_t, n> const&a, std::array<limb_t, m> const&b, Mul_Schoolbook){
+        out.fill(0);
+        for(size_t i=0;i<min(n, k);++i){
+            wide_t carry = 0;
+            for(size_t j=0;j<min(m, k-i);++j){
+                carry+=a[i] * static_cast<wide_t>(b[j]);
+                carry+=out[i+j];
+                out[i+j] = carry;
+                carry>>=LIMB_BITS;
+            }
+            if(i+m < k) out[i+m] = carry;
+        }
+    }
+    /// low k words of the unsigned product
+    /// Splits both operands at h words and computes the middle term as z0 + z2 + (a1-a0)*(b0-b1).
+    template<size_t k, size_t n, size_t m>
+    static void mul_unsigned(std::array<limb_t, k>&out, std::array<limb_t, n> const&a, std::array<limb_t, m> const&b, Mul_Karatsuba){
+        constexpr size_t h = max(n, m) / 2, H = max(n, m) - h;
+        const auto a0 = slice<0, h>(a), b0 = slice<0, h>(b);
+        const auto a1 = slice<h, H>(a), b1 = slice<h, H>(b);
+        std::array<limb_t, 2*h> z0;
+        std::array<limb_t, 2*H> z2, zm;
+        std::array<limb_t, H> da, db;
+        mul_unsigned(z0, a0, b0, mul_kernel_t<2*h, h, h>{});
+        mul_unsigned(z2, a1, b1, mul_kernel_t<2*H, H, H>{});
+        const bool zm_negative = abs_diff(da, a1, a0) == abs_diff(db, b1, b0);
+        mul_unsigned(zm, da, db, mul_kernel_t<2*H, H, H>{});
+        // a1*b0 + a0*b1, non-negative
+        std::array<limb_t, 2*H+1> mid{};
+        add_shifted<0>(mid, z0);
+        add_shifted<0>(mid, z2);
+        if(zm_negative) sub_shifted<0>(mid, zm);
+        else add_shifted<0>(mid, zm);
+        out.fill(0);
+        add_shifted<0>(out, z0);
+        add_shifted<2*h>(out, z2);
+        add_shifted<h>(out, mid);
+    }
+
+
+    /// out = a*b modulo 2^(k*LIMB_BITS), for any word counts of a and b.
+    /// Multiplies as unsigned and then corrects for negative operands,
+    /// as a = a_unsigned - 2^(n*LIMB_BITS) if a is negative.
+    template<size_t k, size_t n, size_t m>
+    static void mul_wide(std::array<limb_t, k>&out, std::array<limb_t, n> const&a, std::array<limb_t, m> const&b){
+        mul_unsigned(out, a, b, mul_kernel_t<k, n, m>{});
+        const bool nega_a = get_pad(a), nega_b = get_pad(b);
+        if(nega_a) sub_shifted<n>(out, b);
+        if(nega_b) sub_shifted<m>(out, a);
+        if(nega_a && nega_b){
+            for(size_t i=n+m;i<k && !++out[i];++i);
+        }
+    }
+
     bool is_negative()const{
-        return data.back()>>31;
+        return data.back()>>(LIMB_BITS-1);
     }
     int sign() const{
         if(is_negative()) return -1;
@@ -254,29 +418,31 @@ public:
     }
     Bigint_Fixedsize_Signed():data{}{}
     explicit Bigint_Fixedsize_Signed(uint32_t const&val):data{val}{}
-    explicit Bigint_Fixedsize_Signed(int32_t const&val):data{static_cast<uint32_t>(val)}{
-        if(val < 0) std::fill(data.begin()+1, data.end(), ~uint32_t{});
+    explicit Bigint_Fixedsize_Signed(int32_t const&val):data{}{
+        assign_integral(val);
+    }
+    template<typename SFINAE = void, typename = enable_if_t<64 <= word_cnt*LIMB_BITS, SFINAE> >
+    explicit Bigint_Fixedsize_Signed(uint64_t const&val):data{}{
+        assign_integral(val);
     }
-    template<typename SFINAE = void, typename = enable_if_t<2 <= word_cnt, SFINAE> >
-    explicit Bigint_Fixedsize_Signed(uint64_t const&val):data{static_cast<uint32_t>(val), static_cast<uint32_t>(val>>32)}{}
-    template<typename SFINAE = void, typename = enable_if_t<2 <= word_cnt, SFINAE> >
-    explicit Bigint_Fixedsize_Signed(int64_t val):data{static_cast<uint32_t>(val), static_cast<uint32_t>(static_cast<uint64_t>(val)>>32)}{
-        if(val<0) std::fill(data.begin()+2, data.end(), ~uint32_t{});
+    template<typename SFINAE = void, typename = enable_if_t<64 <= word_cnt*LIMB_BITS, SFINAE> >
+    explicit Bigint_Fixedsize_Signed(int64_t val):data{}{
+        assign_integral(val);
     }
 #ifdef HAS_INT128
-    template<typename SFINAE = void, typename = enable_if_t<4 <= word_cnt, SFINAE> >
-    Bigint_Fixedsize_Signed(__int128 val):data{static_cast<uint32_t>(val), static_cast<uint32_t>(val>>32), static_cast<uint32_t>(val>>64), static_cast<uint32_t>(val>>96)}{
-        if(val<0) std::fill(data.begin()+4, data.end(), ~uint32_t{});
+    template<typename SFINAE = void, typename = enable_if_t<128 <= word_cnt*LIMB_BITS, SFINAE> >
+    Bigint_Fixedsize_Signed(__int128 val):data{}{
+        assign_integral(val);
     }
 #endif
     template<size_t other_word_cnt, typename = enable_if_t<other_word_cnt <= word_cnt> >
-    explicit Bigint_Fixedsize_Signed(Bigint_Fixedsize_Signed<other_word_cnt> const&val):data{}{
+    explicit Bigint_Fixedsize_Signed(Bigint_Fixedsize_Signed<other_word_cnt, limb_t> const&val):data{}{
         std::copy(val.data.begin(), val.data.end(), data.begin());
-        if(val.is_negative()) std::fill(data.begin()+other_word_cnt, data.end(), ~uint32_t{});
+        if(val.is_negative()) std::fill(data.begin()+other_word_cnt, data.end(), ~limb_t{});
     }
 
     template<size_t other_word_cnt, typename = enable_if_t<other_word_cnt <= word_cnt> >
-    Bigint_Fixedsize_Signed& operator+=(Bigint_Fixedsize_Signed<other_word_cnt> const&o){
+    Bigint_Fixedsize_Signed& operator+=(Bigint_Fixedsize_Signed<other_word_cnt, limb_t> const&o){
         add(data, o.data);
         return *this;
     }
@@ -285,23 +451,23 @@ public:
         return operator+=(Bigint_Fixedsize_Signed(o));
     }
     template<size_t other_word_cnt, typename = enable_if_t<other_word_cnt <= word_cnt> >
-    Bigint_Fixedsize_Signed<word_cnt> operator+(Bigint_Fixedsize_Signed<other_word_cnt> const&o)const{
-        Bigint_Fixedsize_Signed<word_cnt> ret(*this);
+    Bigint_Fixedsize_Signed operator+(Bigint_Fixedsize_Signed<other_word_cnt, limb_t> const&o)const{
+        Bigint_Fixedsize_Signed ret(*this);
         ret+=o;
         return ret;
     }
     template<size_t other_word_cnt, typename = enable_if_t<word_cnt < other_word_cnt> >
-    Bigint_Fixedsize_Signed<other_word_cnt> operator+(Bigint_Fixedsize_Signed<other_word_cnt> const&o)const{
-        Bigint_Fixedsize_Signed<other_word_cnt> ret(o);
+    Bigint_Fixedsize_Signed<other_word_cnt, limb_t> operator+(Bigint_Fixedsize_Signed<other_word_cnt, limb_t> const&o)const{
+        Bigint_Fixedsize_Signed<other_word_cnt, limb_t> ret(o);
         ret+=*this;
         return ret;
     }
     template<typename T, typename = enable_if_by_construction_t<T> >
-    Bigint_Fixedsize_Signed& operator+(T const&o){
+    Bigint_Fixedsize_Signed operator+(T const&o) const {
         return operator+(Bigint_Fixedsize_Signed(o));
     }
     template<size_t other_word_cnt, typename = enable_if_t<other_word_cnt <= word_cnt> >
-    Bigint_Fixedsize_Signed& operator-=(Bigint_Fixedsize_Signed<other_word_cnt> const&o){
+    Bigint_Fixedsize_Signed& operator-=(Bigint_Fixedsize_Signed<other_word_cnt, limb_t> const&o){
         sub(data, o.data);
         return *this;
     }
@@ -310,20 +476,20 @@ public:
         return operator-=(Bigint_Fixedsize_Signed(o));
     }
     template<size_t other_word_cnt, typename = enable_if_t<other_word_cnt <= word_cnt> >
-    Bigint_Fixedsize_Signed<word_cnt> operator-(Bigint_Fixedsize_Signed<other_word_cnt> const&o)const{
-        Bigint_Fixedsize_Signed<word_cnt> ret(*this);
+    Bigint_Fixedsize_Signed operator-(Bigint_Fixedsize_Signed<other_word_cnt, limb_t> const&o)const{
+        Bigint_Fixedsize_Signed ret(*this);
         ret-=o;
         return ret;
     }
     template<size_t other_word_cnt, typename = enable_if_t<word_cnt < other_word_cnt  > >
-    Bigint_Fixedsize_Signed<other_word_cnt> operator-(Bigint_Fixedsize_Signed<other_word_cnt> const&o)const{
-        Bigint_Fixedsize_Signed<other_word_cnt> ret(o);
+    Bigint_Fixedsize_Signed<other_word_cnt, limb_t> operator-(Bigint_Fixedsize_Signed<other_word_cnt, limb_t> const&o)const{
+        Bigint_Fixedsize_Signed<other_word_cnt, limb_t> ret(o);
         ret-=*this;
         ret.negate();
         return ret;
     }
     template<typename T, typename = enable_if_by_construction_t<T> >
-    Bigint_Fixedsize_Signed& operator-(T const&o){
+    Bigint_Fixedsize_Signed operator-(T const&o) const {
         return operator-(Bigint_Fixedsize_Signed(o));
     }
 
@@ -333,16 +499,16 @@ public:
     }
 
     template<size_t other_word_cnt, typename = enable_if_t<other_word_cnt <= word_cnt> >
-    Bigint_Fixedsize_Signed operator*(Bigint_Fixedsize_Signed<other_word_cnt> const&o)const{
+    Bigint_Fixedsize_Signed operator*(Bigint_Fixedsize_Signed<other_word_cnt, limb_t> const&o)const{
         Bigint_Fixedsize_Signed ret;
         mul(ret.data, data, o.data);
         return ret;
     }
     template<size_t other_word_cnt, typename = enable_if_t<word_cnt < other_word_cnt> >
-    Bigint_Fixedsize_Signed<other_word_cnt>& operator*(Bigint_Fixedsize_Signed<other_word_cnt> const&o){
-        Bigint_Fixedsize_Signed<other_word_cnt> ret;
+    Bigint_Fixedsize_Signed<other_word_cnt, limb_t> operator*(Bigint_Fixedsize_Signed<other_word_cnt, limb_t> const&o) const {
+        Bigint_Fixedsize_Signed<other_word_cnt, limb_t> ret;
         mul(ret.data, o.data, data);
-        return *this;
+        return ret;
     }
 
     Bigint_Fixedsize_Signed operator*(uint32_t const&val)const{
@@ -397,26 +563,26 @@ public:
         return *reinterpret_cast<int32_t*>(&ret);
     }
 
-    Bigint_Fixedsize_Signed<word_cnt>& operator<<=(size_t const&s){
+    Bigint_Fixedsize_Signed& operator<<=(size_t const&s){
         left_shift(data, s);
         return *this;
     }
-    Bigint_Fixedsize_Signed<word_cnt> operator<<(size_t const&s)const{
+    Bigint_Fixedsize_Signed operator<<(size_t const&s)const{
         Bigint_Fixedsize_Signed ret(*this);
         ret<<=s;
         return ret;
     }
-    Bigint_Fixedsize_Signed<word_cnt>& operator>>=(size_t const&s){
+    Bigint_Fixedsize_Signed& operator>>=(size_t const&s){
         right_shift(data, s);
         return *this;
     }
-    Bigint_Fixedsize_Signed<word_cnt> operator>>(size_t const&s) const {
+    Bigint_Fixedsize_Signed operator>>(size_t const&s) const {
         Bigint_Fixedsize_Signed ret(*this);
         ret>>=s;
         return ret;
     }
 
-    Bigint_Fixedsize_Signed<word_cnt> operator-() const {
+    Bigint_Fixedsize_Signed operator-() const {
         Bigint_Fixedsize_Signed ret(*this);
         ret.negate();
         return ret;
@@ -434,7 +600,7 @@ public:
 
     static void print_bin(std::ostream&o, Bigint_Fixedsize_Signed val){
         for(auto it = val.data.rbegin(); it != val.data.rend();++it){
-            o << std::bitset<32>(*it);
+            o << std::bitset<LIMB_BITS>(*it);
         }
     }
     friend std::ostream& operator<<(std::ostream&o, Bigint_Fixedsize_Signed val){
@@ -455,7 +621,7 @@ public:
         return o;
     }
     template<size_t other_word_cnt>
-    int comp(Bigint_Fixedsize_Signed<other_word_cnt> const&o)const{
+    int comp(Bigint_Fixedsize_Signed<other_word_cnt, limb_t> const&o)const{
         return signed_comp(data, o.data);
     }
     template<typename T, typename = enable_if_by_construction_t<T>>
@@ -484,19 +650,41 @@ public:
     #undef DECLARE_COMPARISON_OPERATOR
 };
 
+/// smallest Bigint_Fixedsize_Signed with limb_t limbs that holds any T
+template<typename limb_t, typename T>
+Bigint_Fixedsize_Signed<max<size_t>(1, sizeof(T)/sizeof(limb_t)), limb_t> as_bigint(T const&val){
+    return Bigint_Fixedsize_Signed<max<size_t>(1, sizeof(T)/sizeof(limb_t)), limb_t>(val);
+}
+template<typename limb_t, size_t word_cnt>
+Bigint_Fixedsize_Signed<word_cnt, limb_t> const& as_bigint(Bigint_Fixedsize_Signed<word_cnt, limb_t> const&val){
+    return val;
+}
+
+/// ret = a*b, where ret is wide enough to hold the product
+template<typename R, typename S, typename T>
+void widening_mul(R &ret, S const&a, T const&b){
+    ret = static_cast<R>(a);
+    ret*= static_cast<R>(b);
+}
+/// only computes the words of ret, without widening a and b to its size first
+template<size_t word_cnt, typename limb_t, typename S, typename T>
+void widening_mul(Bigint_Fixedsize_Signed<word_cnt, limb_t> &ret, S const&a, T const&b){
+    Bigint_Fixedsize_Signed<word_cnt, limb_t>::mul_wide(ret.data, as_bigint<limb_t>(a).data, as_bigint<limb_t>(b).data);
+}
+
 #ifdef DACIN_HASH_HPP
-template<size_t word_cnt>
-struct Dacin_Hash<Bigint_Fixedsize_Signed<word_cnt>>{
-    size_t operator()(Bigint_Fixedsize_Signed<word_cnt> const&val) const {
+template<size_t word_cnt, typename limb_t>
+struct Dacin_Hash<Bigint_Fixedsize_Signed<word_cnt, limb_t>>{
+    size_t operator()(Bigint_Fixedsize_Signed<word_cnt, limb_t> const&val) const {
         size_t ret = SALT;
-        const uint32_t pad = val.data.back();
+        const limb_t pad = val.data.back();
         int i = val.data.size()-1;
-        if(pad == 0 || pad == ~0u){
+        if(pad == 0 || pad == ~limb_t{}){
             while(i>0 && val.data[i] == pad) --i;
         }
         if(pad != 0 && i+1 < (int)val.data.size()) ++i;
         for(size_t j=0, lim=i+1;j<lim;++j){
-            ret = splitmix64(val.data[i] + ret);
+            ret = splitmix64(val.data[j] + ret);
         }
         return ret;
     }
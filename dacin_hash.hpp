@@ -28,6 +28,15 @@ struct Dacin_Hash<T, enable_if_t<is_same_v<decltype(declval<std::hash<T> >()(dec
     }
 };
 
+#ifdef HAS_INT128
+template<>
+struct Dacin_Hash<__int128>{
+    size_t operator()(__int128 const&x) const {
+        return splitmix64(splitmix64(static_cast<uint64_t>(x)+SALT) + static_cast<uint64_t>(x>>64));
+    }
+};
+#endif // HAS_INT128
+
 template<typename S, typename T>
 struct Dacin_Hash<std::pair<S, T> >{
     size_t operator()(std::pair<S, T> const&x) const {
@@ -8,25 +8,79 @@
 
 namespace dacin::geom{
 
+/// order in which Delaunay::triangulate inserts the points
+enum class Insertion_Order{
+    INPUT,
+    RANDOM,
+    /// along a Hilbert curve, good locality but no randomness
+    HILBERT,
+    /// biased randomized insertion order, random rounds of doubling size, each sorted along a Hilbert curve
+    BRIO
+};
+
+/// position of (x, y) along the Hilbert curve through [0, 2^order)^2
+inline uint64_t hilbert_index(uint32_t x, uint32_t y, int order){
+    const uint32_t side = uint32_t{1} << order;
+    uint64_t ret = 0;
+    for(uint32_t s = side>>1;s;s>>=1){
+        const uint32_t rx = (x & s) > 0, ry = (y & s) > 0;
+        ret+= uint64_t{s} * s * ((3 * rx) ^ ry);
+        // rotate the quadrant
+        if(!ry){
+            if(rx){
+                x = side-1-x;
+                y = side-1-y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return ret;
+}
+
 template<typename point_t>
 struct Delaunay_Face{
+    /// indices of the input points, negative for the infinite vertices
+    std::array<int, 3> vertices;
+    /// filled in by Delaunay::triangulate, the direction of the vertex for infinite vertices
     std::array<point_t, 3> corners;
     std::array<Delaunay_Face*, 3> adj {nullptr, nullptr, nullptr};
-    std::vector<int> bucket;
-    Delaunay_Face(): corners{} {}
-    Delaunay_Face(point_t const&a, point_t const&b, point_t const&c) : corners({a, b, c}) {}
+    /// first uninserted point in the face, by rank in the insertion order, -1 if none
+    /// The others follow in the list Delaunay::bucket_next.
+    int bucket = -1;
+    Delaunay_Face(): vertices{}, corners{} {}
+    Delaunay_Face(int a, int b, int c) : vertices({a, b, c}), corners{} {}
     friend std::ostream& operator<<(std::ostream&o, const Delaunay_Face&ff){
-        o << "Face: " << &ff << "\n";
+        o << "Face: " << &ff << " " << ff.vertices[0] << " " << ff.vertices[1] << " " << ff.vertices[2] << "\n";
         return o << ff.corners[0] << "\n" << ff.corners[1] << "\n" << ff.corners[2] << "\n";
     }
 };
+/// finite triangles of a triangulation, as indices into the input points
+struct Delaunay_Mesh{
+    static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+    /// counter-clockwise corners
+    std::vector<std::array<uint32_t, 3> > triangles;
+    /// neighbors[i][j] is the triangle opposite to triangles[i][j], NONE on the convex hull
+    std::vector<std::array<uint32_t, 3> > neighbors;
+};
+
+/// result of Delaunay::move_points
+struct Delaunay_Repair_Stats{
+    /// Lawson flips on the moved triangulation
+    size_t flips = 0;
+    /// vertices that were removed and inserted again, as their triangles would invert
+    size_t reinserted = 0;
+};
+
 /**
  *  Delaunay triangulation in expected O(n log n)
  *
- *  *Warning*: All points have to be contained in the infinite triangle.
- *  Hence n has to be at least 2 + log_2(max_coord)
+ *  The points are enclosed in a triangle of three symbolic vertices, which lie at
+ *  R * (0, 1), R * (-1, -1) and R * (1, -1) for R -> infinity.
+ *  Predicates involving them use the sign of the limit, so n only has to fit the input.
  *
  *  Does not work with duplicate points, but works in degenerate cases.
+ *  After triangulate, points can be added and removed with insert and remove,
+ *  and moved with move_points.
  *
  */
 template<size_t n>
@@ -36,60 +90,377 @@ public:
     using coord_t = typename Point<n>::coord_t;
     using Face = Delaunay_Face<point_t>;
 
-    static const coord_t INF;
-    static const point_t inf_n, inf_sw, inf_se;
+    /// vertex indices of the infinite vertices
+    static constexpr int INF_N = -1, INF_SW = -2, INF_SE = -3;
 
-    static bool is_infinite(point_t const&p){
-        return (p.x == -INF || p.x == INF || p.y == INF || p.y == -INF);
+    static bool is_infinite(int v){
+        return v < 0;
     }
     static bool is_infinite(Face const&f){
-        return is_infinite(f.corners[0]) || is_infinite(f.corners[1]) || is_infinite(f.corners[2]);
+        return is_infinite(f.vertices[0]) || is_infinite(f.vertices[1]) || is_infinite(f.vertices[2]);
+    }
+    /// vertex index marking a face that is no longer part of the triangulation
+    static constexpr int DELETED = std::numeric_limits<int>::min();
+    static bool is_used(Face const&f){
+        return f.vertices[0] != DELETED;
+    }
+    /// direction in which the infinite vertex v lies
+    static Point<2> infinite_direction(int v){
+        assert(is_infinite(v));
+        static const std::array<Point<2>, 3> directions{Point<2>(0, 1), Point<2>(-1, -1), Point<2>(1, -1)};
+        return directions[-1-v];
     }
 
     Delaunay(){}
 
-    std::vector<Face>& triangulate(std::vector<point_t> const&p){
+    /// vertices of the faces are indices into p
+    std::vector<Face>& triangulate(std::vector<point_t> const&p, Insertion_Order order = Insertion_Order::BRIO, uint64_t seed = 0){
+        build(p, order, seed);
+        compress_faces();
+        return faces;
+    }
+    /// same as triangulate, but only returns the finite triangles as indices
+    Delaunay_Mesh triangulate_mesh(std::vector<point_t> const&p, Insertion_Order order = Insertion_Order::BRIO, uint64_t seed = 0){
+        build(p, order, seed);
+        return get_mesh();
+    }
+
+    /**
+     *  Inserts p into the current triangulation, returns its vertex index.
+     *  If p is already a vertex, returns the index of that vertex instead.
+     *  The point location walks from a vertex near p, found with a coarse grid,
+     *  so an update takes expected O(1) time for evenly spread points.
+     */
+    int insert(point_t const&p){
+        if(faces.empty()) build({}, Insertion_Order::INPUT, 0);
+        const int index = points.size();
+        points.push_back(p);
+        vertex_face.push_back(nullptr);
+        const int ret = insert_vertex(index);
+        if(ret != index){
+            points.pop_back();
+            vertex_face.pop_back();
+        }
+        return ret;
+    }
+    /// removes the vertex v from the triangulation, the indices of the other vertices stay the same
+    void remove(int v){
+        assert(is_vertex(v));
+        // the faces around v in ccw order and the polygon of their far edges
+        std::vector<Face*> star;
+        std::vector<int> link;
+        std::vector<std::pair<Face*, int> > outer;
+        Face* f = vertex_face[v];
+        do{
+            const int i = std::find(f->vertices.begin(), f->vertices.end(), v) - f->vertices.begin();
+            star.push_back(f);
+            link.push_back(f->vertices[(i+1)%3]);
+            outer.emplace_back(f->adj[i], f->adj[i] ? get_other_dir(f, i, f) : -1);
+            f = f->adj[(i+1)%3];
+        } while(f != vertex_face[v]);
+        const int k = link.size();
+        // ear clipping, the link polygon is star shaped, so this never gets stuck
+        std::vector<std::array<int, 3> > triangles;
+        std::vector<int> polygon(k);
+        std::iota(polygon.begin(), polygon.end(), 0);
+        while(polygon.size() > 3){
+            const int m = polygon.size();
+            for(int j=0;;++j){
+                assert(j < m);
+                const int a = polygon[j], b = polygon[(j+1)%m], c = polygon[(j+2)%m];
+                if(!is_ear(link, polygon, a, b, c)) continue;
+                triangles.push_back({a, b, c});
+                polygon.erase(polygon.begin() + (j+1)%m);
+                break;
+            }
+        }
+        triangles.push_back({polygon[0], polygon[1], polygon[2]});
+        // reuse the faces of the star
+        for(int i=0;i<k-2;++i){
+            Face* t = star[i];
+            t->vertices = {link[triangles[i][0]], link[triangles[i][1]], link[triangles[i][2]]};
+            for(int j=0;j<3;++j){
+                const int x = triangles[i][(j+1)%3], y = triangles[i][(j+2)%3];
+                if(y == (x+1)%k){
+                    t->adj[j] = outer[x].first;
+                    if(t->adj[j]) t->adj[j]->adj[outer[x].second] = t;
+                    continue;
+                }
+                for(int l=0;l<k-2;++l){
+                    for(int r=0;r<3;++r){
+                        if(triangles[l][(r+1)%3] == y && triangles[l][(r+2)%3] == x) t->adj[j] = star[l];
+                    }
+                }
+            }
+        }
+        for(int i=k-2;i<k;++i){
+            star[i]->vertices.fill(DELETED);
+            free_faces.push_back(star[i]);
+        }
+        vertex_face[v] = nullptr;
+        --vertex_count;
+        for(int i=0;i<k-2;++i){
+            set_vertex_faces(star[i]);
+            for(int j=0;j<3;++j) flip_stack.emplace_back(star[i], j);
+        }
+        locateFace = star[0];
+        int &hint = grid[grid_cell(points[v])];
+        if(hint == v) hint = -1;
+        restore_delaunay();
+    }
+    /**
+     *  Moves every vertex v to p[v], keeping the vertex indices.
+     *  Restores the Delaunay property by Lawson flips starting from the current triangulation,
+     *  so small motions are repaired in about linear time.
+     *  The vertices of triangles that would invert are removed before and inserted again after.
+     *  The new points have to be distinct, the entries of removed vertices are ignored.
+     */
+    Delaunay_Repair_Stats move_points(std::vector<point_t> const&p){
+        assert(p.size() == points.size());
+        Delaunay_Repair_Stats ret;
+        std::vector<point_t> old_points = std::move(points);
+        points = p;
+        std::vector<int> removed;
+        for(;;){
+            std::vector<int> inverted;
+            for(auto const&f:faces){
+                if(!is_used(f) || ccw_vertices(f.vertices[0], f.vertices[1], f.vertices[2]) > 0) continue;
+                for(int v:f.vertices){
+                    if(!is_infinite(v)) inverted.push_back(v);
+                }
+            }
+            if(inverted.empty()) break;
+            std::sort(inverted.begin(), inverted.end());
+            inverted.erase(std::unique(inverted.begin(), inverted.end()), inverted.end());
+            // the triangulation is Delaunay for the old points, so remove them there
+            points.swap(old_points);
+            for(int v:inverted) remove(v);
+            points.swap(old_points);
+            removed.insert(removed.end(), inverted.begin(), inverted.end());
+        }
+        // every edge once
+        for(auto &f:faces){
+            if(!is_used(f)) continue;
+            for(int j=0;j<3;++j){
+                if(f.adj[j] && &f < f.adj[j]) flip_stack.emplace_back(&f, j);
+            }
+        }
+        ret.flips = restore_delaunay();
+        build_grid();
+        for(int v:removed){
+            const int inserted = insert_vertex(v);
+            assert(inserted == v);
+            (void)inserted;
+        }
+        ret.reinserted = removed.size();
+        return ret;
+    }
+    /// whether v is a vertex of the current triangulation
+    bool is_vertex(int v) const {
+        return 0 <= v && v < static_cast<int>(vertex_face.size()) && vertex_face[v];
+    }
+    /// all points passed to triangulate and insert, indexed by vertex
+    std::vector<point_t> const& get_points() const {
+        return points;
+    }
+    /// the unused faces left by insert and remove are dropped
+    std::vector<Face>& get_faces(){
+        compress_faces();
+        return faces;
+    }
+
+    /// edges between two finite vertices, each once as (smaller index, larger index)
+    std::vector<std::pair<int, int> > get_edges() const {
+        std::vector<std::pair<int, int> > ret;
+        for(auto const&f:faces){
+            if(!is_used(f)) continue;
+            for(int j=0;j<3;++j){
+                const int a = f.vertices[j], b = f.vertices[(j+1)%3];
+                // the face on the other side has the edge as (b, a)
+                if(!is_infinite(a) && a < b) ret.emplace_back(a, b);
+            }
+        }
+        return ret;
+    }
+    Delaunay_Mesh get_mesh() const {
+        std::vector<uint32_t> id(faces.size(), Delaunay_Mesh::NONE);
+        uint32_t cnt = 0;
+        for(size_t i=0;i<faces.size();++i){
+            if(is_used(faces[i]) && !is_infinite(faces[i])) id[i] = cnt++;
+        }
+        Delaunay_Mesh ret;
+        ret.triangles.reserve(cnt);
+        ret.neighbors.reserve(cnt);
+        for(auto const&e:faces){
+            if(!is_used(e) || is_infinite(e)) continue;
+            ret.triangles.push_back({static_cast<uint32_t>(e.vertices[0]), static_cast<uint32_t>(e.vertices[1]), static_cast<uint32_t>(e.vertices[2])});
+            ret.neighbors.emplace_back();
+            for(int i=0;i<3;++i){
+                ret.neighbors.back()[i] = e.adj[i] ? id[e.adj[i] - faces.data()] : Delaunay_Mesh::NONE;
+            }
+        }
+        return ret;
+    }
+
+    /// ccw of the vertices with indices a, b and c
+    int ccw_vertices(int a, int b, int c) const {
+        // rotate the infinite vertices to the back
+        for(int it=0;it<2 && ((is_infinite(a) && !is_infinite(b)) || (is_infinite(b) && !is_infinite(c)));++it){
+            std::tie(a, b, c) = std::make_tuple(b, c, a);
+        }
+        if(!is_infinite(c)) return ccw(points[a], points[b], points[c]);
+        if(!is_infinite(b)){
+            // R * cross(b-a, dir) + cross(a, b)
+            const int ret = (points[b] - points[a]).cross(infinite_direction(c)).sign();
+            return ret ? ret : points[a].cross(points[b]).sign();
+        }
+        if(!is_infinite(a)) return infinite_direction(b).cross(infinite_direction(c)).sign();
+        return (infinite_direction(b) - infinite_direction(a)).cross(infinite_direction(c) - infinite_direction(a)).sign();
+    }
+    /// sign of the incircle determinant of the vertices with indices v, positive if v[3] is inside
+    /// Only used with infinite vertices, as it expands the determinant as a polynomial in R.
+    int incircle_vertices(std::array<int, 4> const&v) const {
+        int inf_cnt = 0;
+        for(int e:v) inf_cnt+= is_infinite(e);
+        for(int power = 2*inf_cnt;power >= 0;--power){
+            Adaptive_Int<4*n+12> coeff(0);
+            // every infinite row is R^2 * (0, 0, |dir|^2, 0) + R * (dir, 0, 0) + (0, 0, 0, 1)
+            for(int choice=0;choice<81;++choice){
+                std::array<int, 4> degree;
+                int total = 0;
+                for(int i=0, c=choice;i<4;++i, c/=3){
+                    degree[i] = c%3;
+                    total+= degree[i];
+                }
+                bool valid = total == power;
+                for(int i=0;i<4;++i) valid&= is_infinite(v[i]) || !degree[i];
+                if(!valid) continue;
+                std::array<Lifted_Row, 4> rows;
+                for(int i=0;i<4;++i) rows[i] = lifted_row(v[i], degree[i]);
+                // expand along the last column
+                for(int i=0;i<4;++i){
+                    if(!rows[i].w) continue;
+                    auto const det = lifted_det3(rows[i==0], rows[1 + (i<=1)], rows[2 + (i<=2)]);
+                    if(i%2) coeff+= make_unsafe(det);
+                    else coeff-= make_unsafe(det);
+                }
+            }
+            const int ret = coeff.sign();
+            if(ret) return ret;
+        }
+        return 0;
+    }
+
+private:
+    void build(std::vector<point_t> const&p, Insertion_Order order, uint64_t seed){
         points = p;
         int N = p.size();
-        faces.reserve(3*N);
-        //std::random_shuffle(points.begin(), points.end());
+        // 1 + 2 per point, so that the faces never move
+        faces.clear();
+        faces.reserve(2*N+1);
+        free_faces.clear();
+        vertex_face.assign(N, nullptr);
+        vertex_count = N;
+        insertion_order = get_insertion_order(order, seed);
 		// start with super triangle that contains all points
-        locateFace = new (getFreeFace()) Face(inf_n, inf_sw, inf_se);
-        locateFace->bucket.resize(N);
-        std::iota(locateFace->bucket.begin(), locateFace->bucket.end(), 0);
-        vertex_location.resize(N, locateFace);
+        locateFace = new (getFreeFace()) Face(INF_N, INF_SW, INF_SE);
+        vertex_location.resize(N);
+        bucket_next.resize(N);
+        for(int i=N-1;i>=0;--i){
+            add_to_bucket(locateFace, i);
+        }
         // incremental construction
         for(int i=0;i<N;++i){
             Face* place = vertex_location[i];
-            split(place, i);
+            split(place, insertion_order[i]);
         }
-        compress_faces();
-        return faces;
+        build_grid();
     }
-
-private:
-    static coord_t get_inf(){
-        coord_t ret(1);
-        const size_t exp = n-1;
-        for(size_t i=1;i<=exp;i<<=1){
-            ret*=make_unsafe(ret);
-            if(exp&i){
-                ret*=make_unsafe(coord_t(2));
+    /// permutation of the point indices
+    std::vector<int> get_insertion_order(Insertion_Order order, uint64_t seed) const {
+        std::vector<int> ret(points.size());
+        std::iota(ret.begin(), ret.end(), 0);
+        if(order == Insertion_Order::INPUT || points.empty()) return ret;
+        std::mt19937_64 rng(seed);
+        if(order == Insertion_Order::RANDOM){
+            std::shuffle(ret.begin(), ret.end(), rng);
+            return ret;
+        }
+        // approximate positions suffice for the order
+        std::vector<std::pair<double, double> > pos(points.size());
+        double min_x = std::numeric_limits<double>::infinity(), max_x = -min_x, min_y = min_x, max_y = max_x;
+        for(size_t i=0;i<points.size();++i){
+            pos[i] = static_cast<std::pair<double, double> >(points[i]);
+            min_x = std::min(min_x, pos[i].first);
+            max_x = std::max(max_x, pos[i].first);
+            min_y = std::min(min_y, pos[i].second);
+            max_y = std::max(max_y, pos[i].second);
+        }
+        const int hilbert_order = 31;
+        const double cells = static_cast<double>(uint32_t{1} << hilbert_order) - 1;
+        const double scale = cells / std::max({max_x - min_x, max_y - min_y, 1.0});
+        std::vector<uint64_t> key(points.size());
+        for(size_t i=0;i<points.size();++i){
+            const uint32_t x = static_cast<uint32_t>(std::min(cells, (pos[i].first - min_x) * scale));
+            const uint32_t y = static_cast<uint32_t>(std::min(cells, (pos[i].second - min_y) * scale));
+            key[i] = hilbert_index(x, y, hilbert_order);
+        }
+        std::vector<int> round(points.size(), 0);
+        if(order == Insertion_Order::BRIO){
+            // every point is in the last round with probability 1/2, in the one before with 1/4, ...
+            const int rounds = 1 + std::__lg(points.size());
+            for(auto &e:round){
+                e = rounds-1;
+                while(e && (rng() & 1)) --e;
             }
         }
+        std::sort(ret.begin(), ret.end(), [&](int const&a, int const&b){
+            return std::tie(round[a], key[a]) < std::tie(round[b], key[b]);
+        });
+        return ret;
+    }
+    /// row (x, y, x^2+y^2, w) of the lifted incircle determinant
+    struct Lifted_Row{
+        coord_t x, y;
+        Adaptive_Int<2*n+1> l;
+        int w;
+    };
+    /// coefficient of R^degree in the row of vertex v
+    Lifted_Row lifted_row(int v, int degree) const {
+        if(!is_infinite(v)){
+            return Lifted_Row{points[v].x, points[v].y, points[v].norm_sq(), 1};
+        }
+        const Point<2> dir = infinite_direction(v);
+        if(degree == 2) return Lifted_Row{coord_t(0), coord_t(0), Adaptive_Int<2*n+1>(dir.norm_sq()), 0};
+        if(degree == 1) return Lifted_Row{coord_t(dir.x), coord_t(dir.y), Adaptive_Int<2*n+1>(0), 0};
+        return Lifted_Row{coord_t(0), coord_t(0), Adaptive_Int<2*n+1>(0), 1};
+    }
+    static Adaptive_Int<4*n+4> lifted_det3(Lifted_Row const&a, Lifted_Row const&b, Lifted_Row const&c){
+        Adaptive_Int<4*n+4> ret(a.x * (b.y*c.l - b.l*c.y));
+        ret-= make_unsafe(a.y * (b.x*c.l - b.l*c.x));
+        ret+= make_unsafe(a.l * (b.x*c.y - b.y*c.x));
         return ret;
     }
-    static bool has_to_flip(Face const&f, point_t const&p){
-        point_t const&A = f.corners[0], B = f.corners[1], C = f.corners[2];
-        // infinite point
-        if(is_infinite(A)) return ccw(B, C, p) > 0;
-        if(is_infinite(B)) return ccw(C, A, p) > 0;
-        if(is_infinite(C)) return ccw(A, B, p) > 0;
-        // degenerate face
-        if(ccw(A, B, C) == 0) return ccw(A, B, p) + ccw(B, C, p) + ccw(C, A, p) > 0;
-        // infinite point is never in finite face
-        if(is_infinite(p)) return false;
-        return is_in_circumcircle(A, B, C, p) > 0;
+
+    bool has_to_flip(Face const&f, int p) const {
+        int A = f.vertices[0], B = f.vertices[1], C = f.vertices[2];
+        const int inf_cnt = is_infinite(A) + is_infinite(B) + is_infinite(C);
+        if(inf_cnt == 0){
+            point_t const&a = points[A], &b = points[B], &c = points[C];
+            // degenerate face
+            if(ccw(a, b, c) == 0) return ccw_vertices(A, B, p) + ccw_vertices(B, C, p) + ccw_vertices(C, A, p) > 0;
+            // infinite point is never in finite face
+            if(is_infinite(p)) return false;
+            return is_in_circumcircle(a, b, c, points[p]) > 0;
+        }
+        if(inf_cnt == 1 && !is_infinite(p)){
+            // the circle converges to the half plane left of the finite edge
+            while(!is_infinite(A)) std::tie(A, B, C) = std::make_tuple(B, C, A);
+            point_t const&b = points[B], &c = points[C], &q = points[p];
+            const int ret = ccw(b, c, q);
+            return ret > 0 || (ret == 0 && (b-q).dot(c-q).sign() < 0);
+        }
+        return incircle_vertices({A, B, C, p}) > 0;
     }
     static int get_other_dir(Face*f, int dir, Face*old_f){
         Face*other = f->adj[dir];
@@ -104,61 +475,186 @@ private:
         f->adj[dir]->adj[other_dir] = f;
     }
 
-    Face* locate(point_t const& p, Face* cur){
-        asser(cur);
+    /// inserts points[index], returns an equal vertex if there is one, otherwise index
+    int insert_vertex(int index){
+        // split needs two faces, which must not move once we hold pointers
+        if(free_faces.size() + faces.capacity() - faces.size() < 2) reserve_faces(2*faces.size() + 2);
+        Face* f = locate(index);
+        for(int v:f->vertices){
+            if(!is_infinite(v) && points[v] == points[index]) return v;
+        }
+        split(f, index);
+        locateFace = f;
+        ++vertex_count;
+        if(vertex_count > 8 * grid_side * grid_side) build_grid();
+        grid[grid_cell(points[index])] = index;
+        return index;
+    }
+    /// square grid over the bounding box of the vertices, with about 4 vertices per cell
+    void build_grid(){
+        grid_side = std::max<int>(1, std::sqrt(vertex_count / 4.0));
+        grid_min = {std::numeric_limits<double>::max(), std::numeric_limits<double>::max()};
+        double max_x = std::numeric_limits<double>::lowest(), max_y = max_x;
+        for(size_t i=0;i<points.size();++i){
+            if(!is_vertex(i)) continue;
+            const double x = static_cast<double>(points[i].x), y = static_cast<double>(points[i].y);
+            grid_min = {std::min(grid_min.first, x), std::min(grid_min.second, y)};
+            max_x = std::max(max_x, x);
+            max_y = std::max(max_y, y);
+        }
+        const double extent = std::max(max_x - grid_min.first, max_y - grid_min.second);
+        grid_scale = extent > 0 ? grid_side / extent : 0;
+        grid.assign(grid_side * grid_side, -1);
+        for(size_t i=0;i<points.size();++i){
+            if(is_vertex(i)) grid[grid_cell(points[i])] = i;
+        }
+    }
+    /// cell of p, points outside of the grid go to the closest cell
+    size_t grid_cell(point_t const&p) const {
+        auto coordinate = [&](double v, double lo){
+            const double c = (v - lo) * grid_scale;
+            return c <= 0 ? 0 : c >= grid_side-1 ? grid_side-1 : static_cast<int>(c);
+        };
+        return coordinate(static_cast<double>(p.x), grid_min.first) * grid_side + coordinate(static_cast<double>(p.y), grid_min.second);
+    }
+    /**
+     *  Face that contains the point p, by a visibility walk
+     *  Starts at a vertex in the grid cell of p, if any, otherwise at the last changed face.
+     *  The walk never goes back through the edge it came from.
+     *  It terminates as the triangulation is Delaunay.
+     */
+    Face* locate(int p){
+        const int hint = grid[grid_cell(points[p])];
+        Face* cur = is_vertex(hint) ? vertex_face[hint] : locateFace;
+        assert(cur && is_used(*cur));
+        Face* prev = nullptr;
         for(int i=0;i<3;++i){
-            if(ccw(cur->corners[i], cur->corners[(i+1)%3], p)<0){
+            if(cur->adj[i] != prev && ccw_vertices(cur->vertices[(i+1)%3], cur->vertices[(i+2)%3], p)<0){
+                prev = cur;
                 cur = cur->adj[i];
                 i=-1;
             }
         }
         return cur;
     }
+    /// whether the corners a, b, c of the polygon with vertices link form an ear
+    bool is_ear(std::vector<int> const&link, std::vector<int> const&polygon, int a, int b, int c) const {
+        const int A = link[a], B = link[b], C = link[c];
+        if(ccw_vertices(A, B, C) <= 0) return false;
+        for(int e:polygon){
+            if(e == a || e == b || e == c) continue;
+            const int E = link[e];
+            if(ccw_vertices(A, B, E) >= 0 && ccw_vertices(B, C, E) >= 0 && ccw_vertices(C, A, E) >= 0) return false;
+        }
+        return true;
+    }
     Face* getFreeFace(){
+        if(!free_faces.empty()){
+            Face* ret = free_faces.back();
+            free_faces.pop_back();
+            return ret;
+        }
+        // the faces must never move
+        assert(faces.size() < faces.capacity());
         faces.emplace_back();
         return &(faces.back());
     }
-    void link_bucket(Face*f){
-        if(!f->bucket.empty()){
-            vertex_location[f->bucket.front()] = f;
+    /// grows the capacity of faces, the face pointers are moved along
+    void reserve_faces(size_t capacity){
+        std::vector<Face> moved;
+        moved.reserve(capacity);
+        moved.insert(moved.end(), std::make_move_iterator(faces.begin()), std::make_move_iterator(faces.end()));
+        Face* const old_base = faces.data();
+        auto rebase = [&](Face*f){
+            return f ? moved.data() + (f - old_base) : nullptr;
+        };
+        for(auto &e:moved){
+            for(auto &g:e.adj) g = rebase(g);
         }
+        for(auto &e:vertex_face) e = rebase(e);
+        for(auto &e:free_faces) e = rebase(e);
+        locateFace = rebase(locateFace);
+        faces.swap(moved);
     }
+    /// makes f the face stored for each of its vertices
+    void set_vertex_faces(Face*f){
+        for(int v:f->vertices){
+            if(!is_infinite(v)) vertex_face[v] = f;
+        }
+    }
+    void add_to_bucket(Face*f, int rank){
+        bucket_next[rank] = f->bucket;
+        f->bucket = rank;
+        vertex_location[rank] = f;
+    }
+    /// flips the edge opposite to the new point f->vertices[dir] and the edges that become illegal by that
     void check_flips(Face*f, int dir){
-        if(f->adj[dir] == 0) return;
-        int other_dir = get_other_dir(f, dir, f);
+        flip_stack.emplace_back(f, dir);
+        while(!flip_stack.empty()){
+            std::tie(f, dir) = flip_stack.back();
+            flip_stack.pop_back();
+            if(f->adj[dir] == nullptr) continue;
+            const int other_dir = get_other_dir(f, dir, f);
+            Face*o = f->adj[dir];
+            if(flip(f, dir, other_dir)){
+                // only the edges opposite to the new point can have become illegal
+                flip_stack.emplace_back(o, (other_dir+1)%3);
+                flip_stack.emplace_back(f, dir);
+            }
+        }
+    }
+    /// Lawson's flip algorithm on the edges in flip_stack, all other edges have to be legal, returns the number of flips
+    size_t restore_delaunay(){
+        size_t flips = 0;
+        while(!flip_stack.empty()){
+            auto [f, dir] = flip_stack.back();
+            flip_stack.pop_back();
+            if(f->adj[dir] == nullptr) continue;
+            const int other_dir = get_other_dir(f, dir, f);
+            Face*o = f->adj[dir];
+            if(flip(f, dir, other_dir)){
+                ++flips;
+                flip_stack.emplace_back(f, dir);
+                flip_stack.emplace_back(f, (dir+1)%3);
+                flip_stack.emplace_back(o, other_dir);
+                flip_stack.emplace_back(o, (other_dir+1)%3);
+            }
+        }
+        return flips;
+    }
+    /// flips the edge between f and o = f->adj[dir] if o->vertices[other_dir] is in the circumcircle of f
+    bool flip(Face*f, int dir, int other_dir){
         Face*o = f->adj[dir];
-        if(has_to_flip(*f, o->corners[other_dir])){
-            f->corners[(dir+1)%3] = o->corners[other_dir];
-            o->corners[(other_dir+1)%3] = f->corners[dir];
-            f->adj[dir] = o->adj[(other_dir+2)%3];
-            o->adj[(other_dir+2)%3] = f;
-            o->adj[other_dir] = f->adj[(dir+2)%3];
-            f->adj[(dir+2)%3] = o;
-            link_face(f, dir, o);
-            link_face(o, other_dir, f);
-            std::vector<int> tmp(f->bucket.size() + o->bucket.size());
-            std::merge(f->bucket.begin(), f->bucket.end(), o->bucket.begin(), o->bucket.end(), tmp.begin());
-            f->bucket.clear();
-            o->bucket.clear();
-            for(int e:tmp){
-                if(ccw(f->corners[dir], f->corners[(dir+1)%3], points[e])>0){
-                    f->bucket.push_back(e);
+        if(!has_to_flip(*f, o->vertices[other_dir])) return false;
+        f->vertices[(dir+1)%3] = o->vertices[other_dir];
+        o->vertices[(other_dir+1)%3] = f->vertices[dir];
+        f->adj[dir] = o->adj[(other_dir+2)%3];
+        o->adj[(other_dir+2)%3] = f;
+        o->adj[other_dir] = f->adj[(dir+2)%3];
+        f->adj[(dir+2)%3] = o;
+        link_face(f, dir, o);
+        link_face(o, other_dir, f);
+        set_vertex_faces(f);
+        set_vertex_faces(o);
+        const std::array<int, 2> old_buckets{f->bucket, o->bucket};
+        f->bucket = o->bucket = -1;
+        for(int e:old_buckets){
+            while(e != -1){
+                const int next = bucket_next[e];
+                if(ccw_vertices(f->vertices[dir], f->vertices[(dir+1)%3], insertion_order[e])>0){
+                    add_to_bucket(f, e);
                 } else {
-                    o->bucket.push_back(e);
+                    add_to_bucket(o, e);
                 }
+                e = next;
             }
-            link_bucket(f);
-            link_bucket(o);
-            check_flips(f, (dir)%3);
-            check_flips(f, (dir+1)%3);
-            check_flips(o, (other_dir)%3);
-            check_flips(o, (other_dir+1)%3);
         }
+        return true;
     }
     void split(Face*a, int point_index){
-        Face*b = new (getFreeFace()) Face(a->corners[0], a->corners[1], points[point_index]);
-        Face*c = new (getFreeFace()) Face(a->corners[1], a->corners[2], points[point_index]);
-        a->corners[1] = points[point_index];
+        Face*b = new (getFreeFace()) Face(a->vertices[0], a->vertices[1], point_index);
+        Face*c = new (getFreeFace()) Face(a->vertices[1], a->vertices[2], point_index);
+        a->vertices[1] = point_index;
         b->adj = {c, a, a->adj[2]};
         c->adj = {a, b, a->adj[0]};
         a->adj = {c, a->adj[1], b};
@@ -166,56 +662,79 @@ private:
         link_face(b, 2, a);
         link_face(c, 2, a);
         link_face(a, 1, a);
-        std::vector<int> tmpBuck;
-        tmpBuck.swap(a->bucket);
-        for(int e:tmpBuck){
-            if(e==point_index) continue;
-            if(ccw(b->corners[1], b->corners[2], points[e])>=0 && ccw(b->corners[2], b->corners[0], points[e])>=0){
-                b->bucket.push_back(e);
-            } else if(ccw(c->corners[1], c->corners[2], points[e])>=0 && ccw(c->corners[2], c->corners[0], points[e])>=0){
-                c->bucket.push_back(e);
+        set_vertex_faces(a);
+        set_vertex_faces(b);
+        set_vertex_faces(c);
+        int e = a->bucket;
+        a->bucket = -1;
+        while(e != -1){
+            const int next = bucket_next[e];
+            const int q = insertion_order[e];
+            if(q == point_index){
+                // inserted
+            } else if(ccw_vertices(b->vertices[1], b->vertices[2], q)>=0 && ccw_vertices(b->vertices[2], b->vertices[0], q)>=0){
+                add_to_bucket(b, e);
+            } else if(ccw_vertices(c->vertices[1], c->vertices[2], q)>=0 && ccw_vertices(c->vertices[2], c->vertices[0], q)>=0){
+                add_to_bucket(c, e);
             } else {
-                a->bucket.push_back(e);
+                add_to_bucket(a, e);
             }
+            e = next;
         }
-        link_bucket(a);
-        link_bucket(b);
-        link_bucket(c);
         check_flips(a, 1);
         check_flips(b, 2);
         check_flips(c, 2);
     }
+    /// moves the used faces to the front, the new position of each face follows from a prefix count
     void compress_faces(){
-        std::vector<Face> retFaces;
-        retFaces.reserve(faces.size()+1);
-        std::unordered_map<Face*, Face*> decode;
-        decode.reserve(faces.size());
-        for(auto &e:faces){
-            if(!decode.count(&e)){
-                retFaces.push_back(e);
-                decode[&e] = &(retFaces.back());
-            }
+        std::vector<int> new_index(faces.size(), -1);
+        int cnt = 0;
+        for(size_t i=0;i<faces.size();++i){
+            if(is_used(faces[i])) new_index[i] = cnt++;
         }
-        for(auto &e:retFaces){
-            for(int i=0;i<3;++i){
-                e.adj[i] = decode[e.adj[i]];
+        Face* const base = faces.data();
+        auto renumber = [&](Face*f){
+            return f ? base + new_index[f - base] : nullptr;
+        };
+        for(size_t i=0;i<faces.size();++i){
+            if(new_index[i] == -1) continue;
+            Face &e = faces[i];
+            for(int j=0;j<3;++j){
+                e.adj[j] = renumber(e.adj[j]);
+                e.corners[j] = is_infinite(e.vertices[j]) ? point_t(infinite_direction(e.vertices[j])) : points[e.vertices[j]];
             }
+            if(new_index[i] != static_cast<int>(i)) faces[new_index[i]] = std::move(e);
         }
-        faces.swap(retFaces);
-        locateFace = decode[locateFace];
+        locateFace = renumber(locateFace);
+        for(auto &e:vertex_face) e = renumber(e);
+        free_faces.clear();
+        faces.resize(cnt);
     }
 
     std::vector<Face> faces;
+    /// pending edge checks of check_flips
+    std::vector<std::pair<Face*, int> > flip_stack;
     std::vector<point_t> points;
+    /// point index of the i-th inserted point
+    std::vector<int> insertion_order;
+    /// face containing the uninserted point of rank i
     std::vector<Face*> vertex_location;
+    /// intrusive lists of the uninserted points in each face, indexed by rank
+    std::vector<int> bucket_next;
+    /// a face incident to each vertex, nullptr for removed vertices
+    std::vector<Face*> vertex_face;
+    /// unused faces, left by remove
+    std::vector<Face*> free_faces;
+    int vertex_count = 0;
+    /// some vertex in each cell of the location grid, -1 if none
+    std::vector<int> grid;
+    int grid_side = 0;
+    std::pair<double, double> grid_min;
+    double grid_scale = 0;
+    /// face changed last, the fallback start of locate
     Face* locateFace = 0;
 };
 
-template<size_t n> const typename Delaunay<n>::coord_t Delaunay<n>::INF = Delaunay<n>::get_inf();
-template<size_t n> const typename Delaunay<n>::point_t Delaunay<n>::inf_n(typename Delaunay<n>::coord_t(0), Delaunay<n>::INF);
-template<size_t n> const typename Delaunay<n>::point_t Delaunay<n>::inf_sw(-Delaunay<n>::INF, -Delaunay<n>::INF);
-template<size_t n> const typename Delaunay<n>::point_t Delaunay<n>::inf_se{Delaunay<n>::INF, -Delaunay<n>::INF};
-
 #ifdef DACIN_HASH_HPP
 template<typename T>
 struct Dacin_Hash<Delaunay_Face<T> >{
@@ -0,0 +1,273 @@
+// Released under GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007, see the LICENSE file.
+// Copyright (C) 2018-2019 Daniel Rutschmann aka. dacin21
+
+#ifndef DELAUNAY_DIVIDE_CONQUER_HPP
+#define DELAUNAY_DIVIDE_CONQUER_HPP
+
+#include "delaunay.hpp"
+
+namespace dacin::geom{
+
+/// directed edge in the quad edge structure of Guibas and Stolfi
+struct Quad_Edge{
+    /// the dual edge, rotated by 90 degrees counter-clockwise
+    Quad_Edge* rot;
+    /// next edge counter-clockwise around the origin
+    Quad_Edge* onext;
+    /// vertex index, -1 for dual and deleted edges
+    int origin;
+    /// triangle to the left, only used to extract the mesh
+    int face;
+
+    Quad_Edge* sym() const { return rot->rot; }
+    Quad_Edge* inv_rot() const { return rot->rot->rot; }
+    Quad_Edge* oprev() const { return rot->onext->rot; }
+    Quad_Edge* lnext() const { return inv_rot()->onext->rot; }
+    Quad_Edge* rprev() const { return sym()->onext; }
+    int dest() const { return sym()->origin; }
+};
+
+/// allocates quad edges in blocks, so that they never move, and recycles deleted edges
+class Quad_Edge_Pool{
+public:
+    /// isolated edge from a to b
+    Quad_Edge* make_edge(int a, int b){
+        Quad_Edge* e;
+        if(!free_edges.empty()){
+            e = free_edges.back();
+            free_edges.pop_back();
+        } else {
+            if(used == BLOCK_SIZE){
+                blocks.emplace_back(new Quad_Edge[4*BLOCK_SIZE]);
+                used = 0;
+            }
+            e = blocks.back().get() + 4*used++;
+        }
+        for(int i=0;i<4;++i){
+            e[i] = Quad_Edge{e + (i+1)%4, nullptr, -1, -1};
+        }
+        e[0].onext = e;
+        e[2].onext = e+2;
+        e[1].onext = e+3;
+        e[3].onext = e+1;
+        e[0].origin = a;
+        e[2].origin = b;
+        return e;
+    }
+    /// removes e from the subdivision
+    void delete_edge(Quad_Edge*e){
+        splice(e, e->oprev());
+        splice(e->sym(), e->sym()->oprev());
+        Quad_Edge* base = std::min({e, e->rot, e->sym(), e->inv_rot()});
+        base->origin = -1;
+        free_edges.push_back(base);
+    }
+    /// calls f on both directions of every edge
+    template<typename F>
+    void for_each_edge(F&& f){
+        for(size_t i=0;i<blocks.size();++i){
+            const size_t cnt = i+1 == blocks.size() ? used : BLOCK_SIZE;
+            for(Quad_Edge* e = blocks[i].get(), *end = e + 4*cnt;e != end;e+= 4){
+                if(e->origin == -1) continue;
+                f(e);
+                f(e+2);
+            }
+        }
+    }
+    /// new edge from the destination of a to the origin of b, such that a, e and b share the left face
+    Quad_Edge* connect(Quad_Edge*a, Quad_Edge*b){
+        Quad_Edge* e = make_edge(a->dest(), b->origin);
+        splice(e, a->lnext());
+        splice(e->sym(), b);
+        return e;
+    }
+    static void splice(Quad_Edge*a, Quad_Edge*b){
+        Quad_Edge* alpha = a->onext->rot;
+        Quad_Edge* beta = b->onext->rot;
+        std::swap(a->onext, b->onext);
+        std::swap(alpha->onext, beta->onext);
+    }
+
+private:
+    static constexpr size_t BLOCK_SIZE = 1<<12;
+    std::vector<std::unique_ptr<Quad_Edge[]> > blocks;
+    size_t used = BLOCK_SIZE;
+    std::vector<Quad_Edge*> free_edges;
+};
+
+/**
+ *  Delaunay triangulation by the divide and conquer algorithm of Guibas and Stolfi in O(n log n)
+ *
+ *  The two halves of the top levels of the recursion are triangulated in parallel,
+ *  on up to thread_cnt threads.
+ *  Uses the same predicates as Delaunay, so for input without four cocircular points,
+ *  the result has the same triangles as Delaunay::triangulate_mesh.
+ *
+ *  Does not work with duplicate points, but works in degenerate cases.
+ *
+ */
+template<size_t n>
+class Delaunay_Divide_Conquer{
+public:
+    using point_t = Point<n>;
+
+    /// finite triangles, as indices into p
+    Delaunay_Mesh triangulate(std::vector<point_t> const&p, size_t thread_cnt = 1){
+        int depth = 0;
+        while((size_t{1}<<depth) < thread_cnt) ++depth;
+        pools.clear();
+        pools.resize(size_t{1}<<depth);
+        order.resize(p.size());
+        std::iota(order.begin(), order.end(), 0);
+        sort_points(p, 0, order.size(), depth);
+        // the recursion works on the sorted copy, which is contiguous in memory
+        points.resize(p.size());
+        for(size_t i=0;i<p.size();++i) points[i] = p[order[i]];
+        Delaunay_Mesh ret;
+        if(p.size() >= 2){
+            build(0, points.size(), depth, 0);
+            ret = get_mesh();
+        }
+        pools.clear();
+        return ret;
+    }
+
+private:
+    /// parallel merge sort of order[l, r) by x, then y, with radix sorted leaves
+    void sort_points(std::vector<point_t> const&p, size_t l, size_t r, int depth){
+        auto less = [&](int a, int b){
+            point_t const&u = p[a], &v = p[b];
+            const int x = u.x.comp(v.x);
+            return x ? x < 0 : u.y < v.y;
+        };
+        if(depth == 0 || r-l < PARALLEL_CUTOFF){
+            radix_sort_lexicographical(order.begin() + l, order.begin() + r, [&](int i) -> point_t const& {return p[i];});
+            return;
+        }
+        const size_t m = l + (r-l)/2;
+        std::thread left([&](){sort_points(p, l, m, depth-1);});
+        sort_points(p, m, r, depth-1);
+        left.join();
+        std::inplace_merge(order.begin() + l, order.begin() + m, order.begin() + r, less);
+    }
+    int ccw_vertices(int a, int b, int c) const {
+        return ccw(points[a], points[b], points[c]);
+    }
+    bool in_circle(int a, int b, int c, int d) const {
+        return is_in_circumcircle(points[a], points[b], points[c], points[d]) > 0;
+    }
+    bool right_of(int x, Quad_Edge const*e) const {
+        return ccw_vertices(x, e->dest(), e->origin) > 0;
+    }
+    bool left_of(int x, Quad_Edge const*e) const {
+        return ccw_vertices(x, e->origin, e->dest()) > 0;
+    }
+    /**
+     *  triangulates the points [l, r) of the sorted points
+     *  Returns the counter-clockwise hull edge out of the leftmost point
+     *  and the clockwise hull edge out of the rightmost point.
+     */
+    std::pair<Quad_Edge*, Quad_Edge*> build(size_t l, size_t r, int depth, size_t pool_index){
+        Quad_Edge_Pool &pool = pools[pool_index];
+        if(r-l == 2){
+            Quad_Edge* a = pool.make_edge(l, l+1);
+            return {a, a->sym()};
+        }
+        if(r-l == 3){
+            Quad_Edge* a = pool.make_edge(l, l+1);
+            Quad_Edge* b = pool.make_edge(l+1, l+2);
+            Quad_Edge_Pool::splice(a->sym(), b);
+            const int side = ccw_vertices(l, l+1, l+2);
+            if(side == 0) return {a, b->sym()};
+            Quad_Edge* c = pool.connect(b, a);
+            if(side > 0) return {a, b->sym()};
+            return {c->sym(), c};
+        }
+        const size_t m = l + (r-l)/2;
+        std::pair<Quad_Edge*, Quad_Edge*> left, right;
+        if(depth > 0 && r-l >= PARALLEL_CUTOFF){
+            std::thread left_thread([&](){left = build(l, m, depth-1, pool_index + (size_t{1}<<(depth-1)));});
+            right = build(m, r, depth-1, pool_index);
+            left_thread.join();
+        } else {
+            left = build(l, m, depth-1, pool_index);
+            right = build(m, r, depth-1, pool_index);
+        }
+        auto [ldo, ldi] = left;
+        auto [rdi, rdo] = right;
+        // lower common tangent
+        for(;;){
+            if(left_of(rdi->origin, ldi)) ldi = ldi->lnext();
+            else if(right_of(ldi->origin, rdi)) rdi = rdi->rprev();
+            else break;
+        }
+        Quad_Edge* base = pool.connect(rdi->sym(), ldi);
+        if(ldi->origin == ldo->origin) ldo = base->sym();
+        if(rdi->origin == rdo->origin) rdo = base;
+        // zip the halves together from bottom to top
+        auto valid = [&](Quad_Edge const*e){return right_of(e->dest(), base);};
+        for(;;){
+            Quad_Edge* lcand = base->sym()->onext;
+            if(valid(lcand)){
+                while(in_circle(base->dest(), base->origin, lcand->dest(), lcand->onext->dest())){
+                    Quad_Edge* next = lcand->onext;
+                    pool.delete_edge(lcand);
+                    lcand = next;
+                }
+            }
+            Quad_Edge* rcand = base->oprev();
+            if(valid(rcand)){
+                while(in_circle(base->dest(), base->origin, rcand->dest(), rcand->oprev()->dest())){
+                    Quad_Edge* next = rcand->oprev();
+                    pool.delete_edge(rcand);
+                    rcand = next;
+                }
+            }
+            const bool lvalid = valid(lcand), rvalid = valid(rcand);
+            if(!lvalid && !rvalid) break;
+            if(!lvalid || (rvalid && in_circle(lcand->dest(), lcand->origin, rcand->origin, rcand->dest()))){
+                base = pool.connect(rcand, base->sym());
+            } else {
+                base = pool.connect(base->sym(), lcand->sym());
+            }
+        }
+        return {ldo, rdo};
+    }
+    /// collects the counter-clockwise triangles of the subdivision
+    Delaunay_Mesh get_mesh(){
+        Delaunay_Mesh ret;
+        std::vector<Quad_Edge*> first_edge;
+        for(auto &pool:pools){
+            pool.for_each_edge([&](Quad_Edge*e){
+                if(e->face != -1) return;
+                Quad_Edge* b = e->lnext(), *c = b->lnext();
+                if(c->lnext() != e || ccw_vertices(e->origin, b->origin, c->origin) <= 0) return;
+                e->face = b->face = c->face = ret.triangles.size();
+                ret.triangles.push_back({static_cast<uint32_t>(order[e->origin]), static_cast<uint32_t>(order[b->origin]), static_cast<uint32_t>(order[c->origin])});
+                first_edge.push_back(e);
+            });
+        }
+        ret.neighbors.resize(ret.triangles.size());
+        for(size_t i=0;i<first_edge.size();++i){
+            Quad_Edge* e = first_edge[i];
+            // the edge starting at corner j is opposite to corner j+2
+            for(int j=0;j<3;++j, e = e->lnext()){
+                const int o = e->sym()->face;
+                ret.neighbors[i][(j+2)%3] = o == -1 ? Delaunay_Mesh::NONE : o;
+            }
+        }
+        return ret;
+    }
+
+    /// subproblems below this size are not split across threads
+    static constexpr size_t PARALLEL_CUTOFF = 1<<12;
+    std::vector<point_t> points;
+    /// input index of the sorted points
+    std::vector<int> order;
+    /// one pool per thread, so that the threads never share a free list
+    std::vector<Quad_Edge_Pool> pools;
+};
+
+} // namespace dacin::geom
+
+#endif // DELAUNAY_DIVIDE_CONQUER_HPP
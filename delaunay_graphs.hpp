@@ -0,0 +1,82 @@
+// Released under GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007, see the LICENSE file.
+// Copyright (C) 2018-2019 Daniel Rutschmann aka. dacin21
+
+#ifndef DELAUNAY_GRAPHS_HPP
+#define DELAUNAY_GRAPHS_HPP
+
+#include "delaunay.hpp"
+
+namespace dacin::geom{
+
+/**
+ *  Euclidean minimum spanning tree of the vertices of d, in O(n log n)
+ *  Kruskal's algorithm on the Delaunay edges, which contain a minimum spanning tree.
+ *  Returns the tree edges as pairs of vertex indices, by increasing length.
+ */
+template<size_t n>
+std::vector<std::pair<int, int> > euclidean_mst(Delaunay<n> const&d){
+    auto const&p = d.get_points();
+    auto const edges = d.get_edges();
+    using dist_t = decltype((p[0] - p[0]).norm_sq());
+    std::vector<dist_t> length;
+    length.reserve(edges.size());
+    for(auto const&e:edges) length.push_back((p[e.first] - p[e.second]).norm_sq());
+    std::vector<int> order(edges.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](int a, int b){return length[a] < length[b];});
+    // union find with path halving
+    std::vector<int> parent(p.size());
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&](int x){
+        while(parent[x] != x) x = parent[x] = parent[parent[x]];
+        return x;
+    };
+    std::vector<std::pair<int, int> > ret;
+    for(int i:order){
+        const int a = find(edges[i].first), b = find(edges[i].second);
+        if(a == b) continue;
+        parent[a] = b;
+        ret.push_back(edges[i]);
+    }
+    return ret;
+}
+template<size_t n>
+std::vector<std::pair<int, int> > euclidean_mst(std::vector<Point<n> > const&p){
+    Delaunay<n> d;
+    d.triangulate(p);
+    return euclidean_mst(d);
+}
+
+/**
+ *  Nearest neighbor of every vertex of d, in O(n)
+ *  The nearest neighbor of a vertex is one of its Delaunay neighbors.
+ *  Ties are broken arbitrarily, -1 for removed vertices and if there is only one vertex.
+ */
+template<size_t n>
+std::vector<int> nearest_neighbors(Delaunay<n> const&d){
+    auto const&p = d.get_points();
+    using dist_t = decltype((p[0] - p[0]).norm_sq());
+    std::vector<int> ret(p.size(), -1);
+    std::vector<dist_t> best(p.size());
+    auto update = [&](int a, int b, dist_t const&length){
+        if(ret[a] != -1 && best[a] <= length) return;
+        ret[a] = b;
+        best[a] = length;
+    };
+    for(auto const&e:d.get_edges()){
+        const dist_t length = (p[e.first] - p[e.second]).norm_sq();
+        update(e.first, e.second, length);
+        update(e.second, e.first, length);
+    }
+    return ret;
+}
+template<size_t n>
+std::vector<int> nearest_neighbors(std::vector<Point<n> > const&p){
+    Delaunay<n> d;
+    d.triangulate(p);
+    return nearest_neighbors(d);
+}
+
+} // namespace dacin::geom
+
+#endif // DELAUNAY_GRAPHS_HPP
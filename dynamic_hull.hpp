@@ -0,0 +1,379 @@
+// Released under GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007, see the LICENSE file.
+// Copyright (C) 2018-2019 Daniel Rutschmann aka. dacin21
+
+#ifndef DYNAMIC_HULL_HPP
+#define DYNAMIC_HULL_HPP
+
+#include "geom_2d.hpp"
+
+namespace dacin::geom{
+
+/**
+ *  Upper hull of a set of points under insertions and deletions, in the style of Overmars and van Leeuwen
+ *
+ *  Leaf oriented search tree over the points in lexicographical order, every inner node stores
+ *  the bridge between the upper hulls of its two subtrees, but not the hulls themselves.
+ *  Bridges are found by descending into both subtrees at once, in O(log n).
+ *  Points with equal x are ordered as if sheared by an infinitesimal amount, so the upper hull
+ *  runs from the lexicographically smallest to the lexicographically largest point.
+ *  Balanced by rebuilding subtrees as in a scapegoat tree, updates take amortized O(log^2 n).
+ */
+template<size_t n>
+class Upper_Hull_Tree{
+public:
+    using point_t = Point<n>;
+
+    /// returns false if p was already present
+    bool insert(point_t const&p){
+        if(root == NONE){
+            root = new_leaf(p);
+            max_size = 1;
+            return true;
+        }
+        path.clear();
+        int v = root;
+        while(!is_leaf(v)){
+            path.push_back(v);
+            v = p.comp_lexicographical(nodes[v].key) <= 0 ? nodes[v].left : nodes[v].right;
+        }
+        const int c = p.comp_lexicographical(nodes[v].key);
+        if(c == 0) return false;
+        const int leaf = new_leaf(p);
+        const int inner = new_node();
+        nodes[inner].left = c < 0 ? leaf : v;
+        nodes[inner].right = c < 0 ? v : leaf;
+        nodes[inner].key = nodes[nodes[inner].left].key;
+        // recycled nodes keep the size of a freed subtree, which the balance check below reads
+        nodes[inner].size = 2;
+        replace_child(path.empty() ? NONE : path.back(), v, inner);
+        for(int u:path) ++nodes[u].size;
+        path.push_back(inner);
+        max_size = std::max(max_size, size());
+        // a path this long contains a node whose larger child has more than ALPHA of its leaves
+        size_t last = path.size();
+        if(path.size() > 1 + std::log(size()) / std::log(1 / ALPHA)){
+            for(size_t i=0;i<path.size();++i){
+                Node const&u = nodes[path[i]];
+                if(std::max(nodes[u.left].size, nodes[u.right].size) > ALPHA * u.size){
+                    const int rebuilt = rebuild(path[i]);
+                    replace_child(i ? path[i-1] : NONE, path[i], rebuilt);
+                    last = i;
+                    break;
+                }
+            }
+        }
+        for(size_t i=last;i--;) update(path[i]);
+        return true;
+    }
+    /// returns false if p was not present
+    bool erase(point_t const&p){
+        if(root == NONE) return false;
+        path.clear();
+        int v = root;
+        while(!is_leaf(v)){
+            path.push_back(v);
+            v = p.comp_lexicographical(nodes[v].key) <= 0 ? nodes[v].left : nodes[v].right;
+        }
+        if(nodes[v].key != p) return false;
+        free_nodes.push_back(v);
+        if(path.empty()){
+            root = NONE;
+            return true;
+        }
+        const int parent = path.back();
+        path.pop_back();
+        const int sibling = nodes[parent].left == v ? nodes[parent].right : nodes[parent].left;
+        replace_child(path.empty() ? NONE : path.back(), parent, sibling);
+        free_nodes.push_back(parent);
+        for(int u:path) --nodes[u].size;
+        if(size() < ALPHA * max_size){
+            root = rebuild(root);
+            max_size = size();
+        } else {
+            for(size_t i=path.size();i--;) update(path[i]);
+        }
+        return true;
+    }
+    size_t size() const {
+        return root == NONE ? 0 : nodes[root].size;
+    }
+    point_t const& min() const {
+        int v = root;
+        while(!is_leaf(v)) v = nodes[v].left;
+        return nodes[v].key;
+    }
+    point_t const& max() const {
+        int v = root;
+        while(!is_leaf(v)) v = nodes[v].right;
+        return nodes[v].key;
+    }
+    /// 1: strictly below the upper hull, 0: on it, -1: above it or outside of its x-range
+    int side(point_t const&c) const {
+        if(root == NONE) return -1;
+        int v = root;
+        // an edge of the hull of a subtree containing c is also an edge of the whole hull
+        while(!is_leaf(v)){
+            Node const&x = nodes[v];
+            if(c.comp_lexicographical(x.a) < 0) v = x.left;
+            else if(c.comp_lexicographical(x.b) > 0) v = x.right;
+            else return -ccw(x.a, x.b, c);
+        }
+        return nodes[v].key == c ? 0 : -1;
+    }
+    /// first hull vertex maximizing the dot product with dir, needs dir.y > 0
+    template<size_t m>
+    point_t const& extreme(Point<m> const&dir) const {
+        return search([&](point_t const&a, point_t const&b){return dir.dot(b - a) > 0;});
+    }
+    /// vertex touched by the line through c with minimum slope above all points left of c, the leftmost if there are several
+    point_t const& tangent_left(point_t const&c) const {
+        return search([&](point_t const&a, point_t const&b){return b.comp_lexicographical(c) < 0 && ccw(a, b, c) < 0;});
+    }
+    /// vertex touched by the line through c with maximum slope above all points right of c, the rightmost if there are several
+    point_t const& tangent_right(point_t const&c) const {
+        return search([&](point_t const&a, point_t const&b){return a.comp_lexicographical(c) < 0 || ccw(c, a, b) >= 0;});
+    }
+    /// appends the vertices of the upper hull from left to right, in O(h log n)
+    void get_hull(std::vector<point_t> &out) const {
+        if(root != NONE) collect_hull(root, nullptr, nullptr, out);
+    }
+
+private:
+    static constexpr int NONE = -1;
+    static constexpr double ALPHA = 0.7;
+    struct Node{
+        /// children, NONE for leaves
+        int left, right;
+        /// number of leaves
+        size_t size;
+        /// the point of a leaf, for inner nodes at least the largest and less than the smallest point of the right subtree
+        point_t key;
+        /// bridge between the upper hulls of the subtrees
+        point_t a, b;
+    };
+
+    bool is_leaf(int v) const {
+        return nodes[v].left == NONE;
+    }
+    int new_node(){
+        if(!free_nodes.empty()){
+            const int v = free_nodes.back();
+            free_nodes.pop_back();
+            return v;
+        }
+        nodes.emplace_back();
+        return nodes.size() - 1;
+    }
+    int new_leaf(point_t const&p){
+        const int v = new_node();
+        nodes[v].left = nodes[v].right = NONE;
+        nodes[v].size = 1;
+        nodes[v].key = p;
+        return v;
+    }
+    void replace_child(int parent, int old_child, int new_child){
+        if(parent == NONE) root = new_child;
+        else if(nodes[parent].left == old_child) nodes[parent].left = new_child;
+        else nodes[parent].right = new_child;
+    }
+    void update(int v){
+        Node &x = nodes[v];
+        x.size = nodes[x.left].size + nodes[x.right].size;
+        std::tie(x.a, x.b) = find_bridge(x.left, x.right, x.key);
+    }
+    /// whether the intersection of the non-parallel lines through a1, a2 and b1, b2 is lexicographically at most k
+    static bool intersection_at_most(point_t const&a1, point_t const&a2, point_t const&b1, point_t const&b2, point_t const&k){
+        auto const d1 = a2 - a1, d2 = b2 - b1;
+        auto const den = d1.cross(d2);
+        auto const num = (b1 - a1).cross(d2);
+        // the intersection is a1 + d1 * num / den
+        int s = ((a1.x - k.x) * den + num * d1.x).sign();
+        if(s == 0) s = ((a1.y - k.y) * den + num * d1.y).sign();
+        return (den.sign() < 0 ? -s : s) <= 0;
+    }
+    /**
+     *  upper bridge between the subtrees l and r, all points of l are at most key, all points of r are larger
+     *  Its endpoints are the leftmost and the rightmost point on the common tangent.
+     *  Each step moves to a child in one of the subtrees, keeping the endpoint of the bridge in it.
+     */
+    std::pair<point_t, point_t> find_bridge(int l, int r, point_t const&key) const {
+        while(!is_leaf(l) || !is_leaf(r)){
+            Node const&x = nodes[l], &y = nodes[r];
+            if(is_leaf(l)){
+                r = ccw(x.key, y.a, y.b) >= 0 ? y.right : y.left;
+            } else if(is_leaf(r)){
+                l = ccw(x.a, x.b, y.key) < 0 ? x.right : x.left;
+            } else if(ccw(x.a, x.b, y.a) > 0 || ccw(x.a, x.b, y.b) > 0){
+                // the edge of x is not on the merged hull, so it is right of the bridge
+                l = x.left;
+            } else if(ccw(y.a, y.b, x.a) > 0 || ccw(y.a, y.b, x.b) > 0){
+                r = y.right;
+            } else if((x.b - x.a).cross(y.b - y.a).sign() >= 0){
+                // both edges lie on the bridge
+                l = x.left;
+            } else if(intersection_at_most(x.a, x.b, y.a, y.b, key)){
+                // the lines of the edges cross left of the split, so the edge of x is left of the bridge
+                l = x.right;
+            } else {
+                r = y.left;
+            }
+        }
+        return {nodes[l].key, nodes[r].key};
+    }
+    /**
+     *  Descends along the upper hull, going right at edges a -> b with pred(a, b)
+     *  pred has to be true exactly on the edges left of the result, also for the hulls of subtrees containing it.
+     */
+    template<typename Pred>
+    point_t const& search(Pred&& pred) const {
+        assert(root != NONE);
+        int v = root;
+        while(!is_leaf(v)){
+            v = pred(nodes[v].a, nodes[v].b) ? nodes[v].right : nodes[v].left;
+        }
+        return nodes[v].key;
+    }
+    /// hull vertices of the subtree of v between lo and hi, nullptr for no bound
+    void collect_hull(int v, point_t const*lo, point_t const*hi, std::vector<point_t> &out) const {
+        Node const&x = nodes[v];
+        if(is_leaf(v)){
+            out.push_back(x.key);
+            return;
+        }
+        if(!lo || lo->comp_lexicographical(x.a) <= 0){
+            collect_hull(x.left, lo, hi && hi->comp_lexicographical(x.a) < 0 ? hi : &x.a, out);
+        }
+        if(!hi || x.b.comp_lexicographical(*hi) <= 0){
+            collect_hull(x.right, lo && lo->comp_lexicographical(x.b) > 0 ? lo : &x.b, hi, out);
+        }
+    }
+    /// makes the subtree of v perfectly balanced, returns its new root
+    int rebuild(int v){
+        leaves.clear();
+        std::vector<int> &stack = path_rebuild;
+        stack.assign(1, v);
+        while(!stack.empty()){
+            const int u = stack.back();
+            stack.pop_back();
+            if(is_leaf(u)){
+                leaves.push_back(u);
+            } else {
+                free_nodes.push_back(u);
+                stack.push_back(nodes[u].right);
+                stack.push_back(nodes[u].left);
+            }
+        }
+        return build(0, leaves.size());
+    }
+    int build(size_t l, size_t r){
+        if(r-l == 1) return leaves[l];
+        const size_t m = l + (r-l)/2;
+        const int v = new_node();
+        const int left = build(l, m), right = build(m, r);
+        nodes[v].left = left;
+        nodes[v].right = right;
+        nodes[v].key = nodes[leaves[m-1]].key;
+        update(v);
+        return v;
+    }
+
+    std::vector<Node> nodes;
+    std::vector<int> free_nodes;
+    int root = NONE;
+    /// number of points after the last rebuild of the whole tree, or more
+    size_t max_size = 0;
+    /// buffers
+    std::vector<int> path, path_rebuild, leaves;
+};
+
+/**
+ *  Convex hull of a set of points under insertions and deletions
+ *  The lower hull is the negated upper hull of the negated points.
+ *  Updates take amortized O(log^2 n), queries O(log n).
+ */
+template<size_t n>
+class Dynamic_Hull{
+public:
+    using point_t = Point<n>;
+
+    /// returns false if p was already present
+    bool insert(point_t const&p){
+        if(!upper.insert(p)) return false;
+        lower.insert(negate(p));
+        return true;
+    }
+    /// returns false if p was not present
+    bool erase(point_t const&p){
+        if(!upper.erase(p)) return false;
+        lower.erase(negate(p));
+        return true;
+    }
+    size_t size() const {
+        return upper.size();
+    }
+    /// 1: strictly inside, 0: on the boundary, -1: outside
+    int contains(point_t const&c) const {
+        return std::min(upper.side(c), lower.side(negate(c)));
+    }
+    /// a hull vertex maximizing the dot product with dir, the set must not be empty
+    template<size_t m>
+    point_t extreme_point(Point<m> const&dir) const {
+        // the upper hull may start with a vertical edge, which is not extreme for horizontal directions
+        if(dir.y == 0) return dir.x > 0 ? upper.max() : upper.min();
+        if(dir.y > 0) return upper.extreme(dir);
+        return negate(lower.extreme(Point<m>(-dir.x, -dir.y)));
+    }
+    /**
+     *  The two hull vertices touched by the tangents through c, which must be outside
+     *  All points s satisfy ccw(c, first, s) >= 0 and ccw(c, second, s) <= 0.
+     *  If a tangent touches several points, returns the farthest one.
+     */
+    std::pair<point_t, point_t> tangents(point_t const&c) const {
+        assert(size() && contains(c) < 0);
+        const point_t nc = negate(c);
+        point_t t, u;
+        if(c.comp_lexicographical(upper.min()) < 0){
+            t = upper.tangent_right(c);
+            u = negate(lower.tangent_left(nc));
+        } else if(c.comp_lexicographical(upper.max()) > 0){
+            t = upper.tangent_left(c);
+            u = negate(lower.tangent_right(nc));
+        } else if(upper.side(c) < 0){
+            t = upper.tangent_left(c);
+            u = upper.tangent_right(c);
+        } else {
+            t = negate(lower.tangent_left(nc));
+            u = negate(lower.tangent_right(nc));
+        }
+        if(ccw(c, t, u) < 0) std::swap(t, u);
+        return {t, u};
+    }
+    /// same as convex_hull of the current points, in O(h log n)
+    std::vector<point_t> get_hull() const {
+        std::vector<point_t> ret, up;
+        if(size() <= 1){
+            if(size()) ret.push_back(upper.min());
+            return ret;
+        }
+        lower.get_hull(ret);
+        for(auto &e:ret) e = negate(e);
+        std::reverse(ret.begin(), ret.end());
+        ret.pop_back();
+        upper.get_hull(up);
+        ret.insert(ret.end(), up.rbegin(), up.rend() - 1);
+        return ret;
+    }
+
+private:
+    static point_t negate(point_t const&p){
+        return point_t(-p.x, -p.y);
+    }
+
+    Upper_Hull_Tree<n> upper;
+    /// upper hull of the negated points
+    Upper_Hull_Tree<n> lower;
+};
+
+} // namespace dacin::geom
+
+#endif // DYNAMIC_HULL_HPP
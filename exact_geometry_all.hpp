@@ -6,5 +6,12 @@
 #include "dacin_hash.hpp"
 #include "bignum_fixedsize_signed.hpp"
 #include "adaptive_int.hpp"
+#include "floating_filter.hpp"
 #include "geom_2d.hpp"
+#include "dynamic_hull.hpp"
+#include "streaming_hull.hpp"
+#include "rotating_calipers.hpp"
 #include "delaunay.hpp"
+#include "delaunay_divide_conquer.hpp"
+#include "delaunay_graphs.hpp"
+#include "voronoi.hpp"
@@ -0,0 +1,170 @@
+// Released under GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007, see the LICENSE file.
+// Copyright (C) 2018-2019 Daniel Rutschmann aka. dacin21
+
+#ifndef FLOATING_FILTER_HPP
+#define FLOATING_FILTER_HPP
+
+#include "geom_utility.hpp"
+#include "adaptive_int.hpp"
+
+namespace dacin::geom{
+
+/**
+ *  Compile time error bounds for evaluating predicates in double.
+ *
+ *  A filtered predicate returns UNCERTAIN_SIGN if the rounding error
+ *  could have changed the sign, the caller then falls back to exact arithmetic.
+ */
+
+constexpr int UNCERTAIN_SIGN = 2;
+
+/// unit roundoff, 2^-53
+constexpr double FLOAT_EPS = std::numeric_limits<double>::epsilon() / 2;
+
+/// bound on the relative error of k chained roundings
+constexpr double float_gamma(size_t k){
+    return k * FLOAT_EPS / (1 - k * FLOAT_EPS);
+}
+
+/// relative error of static_cast<double>(Adaptive_Int<n>)
+/// exact up to 53 bits, otherwise at most one rounding per word of the backend and one for the sign
+constexpr double float_conversion_error(size_t n){
+    return n <= 53 ? 0.0 : float_gamma(n/32 + 3);
+}
+
+/// Shewchuk's bound for a 2x2 determinant of differences of exactly representable inputs
+constexpr double CCW_ERRBOUND_EXACT_INPUT = (3 + 16 * FLOAT_EPS) * FLOAT_EPS;
+
+/// Bound for (bx-ax)*(cy-ay) - (by-ay)*(cx-ax) with inputs of relative error d,
+/// relative to (|ax|+|bx|)*(|ay|+|cy|) + (|ay|+|by|)*(|ax|+|cx|) evaluated in double.
+constexpr double ccw_errbound_rounded_input(double d){
+    const double u = FLOAT_EPS;
+    const double diff = d + u * (1 + u) * (1 + d);
+    const double prod = diff * (2 + diff) + u * (1 + diff) * (1 + diff);
+    const double det = prod + u * (1 + u) * (1 + diff) * (1 + diff);
+    const double lost = (1 - u) * (1 - u) * (1 - u) * (1 - u) * (1 - u) * (1 - d) * (1 - d);
+    return det / lost * (1 + 64 * u);
+}
+
+/// Worst case magnitude and absolute error of a value computed in double.
+/// Used to derive static filter bounds from the bit width of the inputs.
+struct Float_Error{
+    double mag, err;
+
+    /// input with |value| <= 2^bits
+    static constexpr Float_Error input(size_t bits){
+        double mag = 1;
+        for(size_t i=0;i<bits;++i) mag*=2;
+        return Float_Error{mag, mag * float_conversion_error(bits)};
+    }
+    friend constexpr Float_Error operator+(Float_Error const&a, Float_Error const&b){
+        const double mag = a.mag + b.mag, err = a.err + b.err;
+        return Float_Error{mag, err + FLOAT_EPS * (mag + err)};
+    }
+    friend constexpr Float_Error operator-(Float_Error const&a, Float_Error const&b){
+        return a + b;
+    }
+    friend constexpr Float_Error operator*(Float_Error const&a, Float_Error const&b){
+        const double mag = a.mag * b.mag, err = a.mag * b.err + b.mag * a.err + a.err * b.err;
+        return Float_Error{mag, err + FLOAT_EPS * (mag + err)};
+    }
+    /// error bound, with slack for the rounding of the bound itself
+    constexpr double bound() const {
+        return err * (1 + 256 * FLOAT_EPS);
+    }
+};
+
+/**
+ *  Interval arithmetic in double with outward rounding.
+ *
+ *  Every operation is rounded to nearest and then widened by more than half an ulp,
+ *  so no change of the rounding mode is needed.
+ */
+class Interval{
+public:
+    double lo, hi;
+
+    Interval(double lo_, double hi_) : lo(lo_), hi(hi_) {}
+    /// value with relative error at most rel_err
+    static Interval with_relative_error(double val, double rel_err){
+        if(rel_err == 0) return Interval(val, val);
+        const double err = std::abs(val) * (rel_err / (1 - rel_err));
+        return Interval(round_down(val - err), round_up(val + err));
+    }
+    template<size_t n>
+    static Interval from(Adaptive_Int<n> const&val){
+        return with_relative_error(static_cast<double>(val), float_conversion_error(n));
+    }
+
+    friend Interval operator+(Interval const&a, Interval const&b){
+        return Interval(round_down(a.lo + b.lo), round_up(a.hi + b.hi));
+    }
+    friend Interval operator-(Interval const&a, Interval const&b){
+        return Interval(round_down(a.lo - b.hi), round_up(a.hi - b.lo));
+    }
+    friend Interval operator*(Interval const&a, Interval const&b){
+        const double p1 = a.lo * b.lo, p2 = a.lo * b.hi, p3 = a.hi * b.lo, p4 = a.hi * b.hi;
+        // 0 * inf, the comparisons below would silently drop it
+        if(std::isnan(p1 + p2 + p3 + p4)) return Interval(-std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity());
+        return Interval(round_down(std::min(std::min(p1, p2), std::min(p3, p4))), round_up(std::max(std::max(p1, p2), std::max(p3, p4))));
+    }
+    /// sign of every value in the interval, UNCERTAIN_SIGN if it contains 0
+    int sign() const {
+        if(lo > 0) return 1;
+        if(hi < 0) return -1;
+        return UNCERTAIN_SIGN;
+    }
+
+private:
+    static double round_down(double val){
+        return val - 4 * FLOAT_EPS * std::abs(val) - std::numeric_limits<double>::min();
+    }
+    static double round_up(double val){
+        return val + 4 * FLOAT_EPS * std::abs(val) + std::numeric_limits<double>::min();
+    }
+};
+
+/// sign of value if it exceeds the error bound, UNCERTAIN_SIGN otherwise
+inline int filtered_sign(double value, double errbound){
+    if(value > errbound) return 1;
+    if(-value > errbound) return -1;
+    return UNCERTAIN_SIGN;
+}
+
+/// bound for fl(a*b) - fl(c*d) with a, c of n bits and b, d of m bits, relative to |fl(a*b)| + |fl(c*d)|
+constexpr double compare_products_errbound(size_t n, size_t m){
+    const double rel = (1 + float_conversion_error(n)) * (1 + float_conversion_error(m)) * (1 + FLOAT_EPS) - 1;
+    return (rel / (1 - rel) + FLOAT_EPS) * (1 + 64 * FLOAT_EPS);
+}
+
+template<size_t n1, size_t m1, size_t n2, size_t m2>
+int compare_products_impl(Adaptive_Int<n1> const&a, Adaptive_Int<m1> const&b, Adaptive_Int<n2> const&c, Adaptive_Int<m2> const&d, std::true_type){
+    return (a*b).comp(c*d);
+}
+template<size_t n1, size_t m1, size_t n2, size_t m2>
+int compare_products_impl(Adaptive_Int<n1> const&a, Adaptive_Int<m1> const&b, Adaptive_Int<n2> const&c, Adaptive_Int<m2> const&d, std::false_type){
+    // products of different sign don't need any multiplication
+    const int sign_ab = a.sign() * b.sign(), sign_cd = c.sign() * d.sign();
+    if(sign_ab != sign_cd || !sign_ab) return (sign_ab > sign_cd) - (sign_ab < sign_cd);
+    // only the leading words matter for the conversion to double
+    const double ab = static_cast<double>(a) * static_cast<double>(b);
+    const double cd = static_cast<double>(c) * static_cast<double>(d);
+    constexpr double errbound = compare_products_errbound(max(n1, n2), max(m1, m2));
+    const int ret = filtered_sign(ab - cd, errbound * (std::abs(ab) + std::abs(cd)));
+    return ret != UNCERTAIN_SIGN ? ret : (a*b).comp(c*d);
+}
+/// sign of a*b - c*d
+/// Decided in double from the leading words when possible, the products are only formed if that is inconclusive.
+template<size_t n1, size_t m1, size_t n2, size_t m2>
+int compare_products(Adaptive_Int<n1> const&a, Adaptive_Int<m1> const&b, Adaptive_Int<n2> const&c, Adaptive_Int<m2> const&d){
+    return compare_products_impl(a, b, c, d, integral_constant<bool, Adaptive_Int<max(n1+m1, n2+m2)>::has_native_backend>{});
+}
+/// sign of the determinant |a b; c d|
+template<size_t n1, size_t m1, size_t n2, size_t m2>
+int sign_of_det2(Adaptive_Int<n1> const&a, Adaptive_Int<m1> const&b, Adaptive_Int<n2> const&c, Adaptive_Int<m2> const&d){
+    return compare_products(a, d, c, b);
+}
+
+} // namespace dacin::geom
+
+#endif // FLOATING_FILTER_HPP
@@ -6,6 +6,7 @@
 
 #include "geom_utility.hpp"
 #include "adaptive_int.hpp"
+#include "floating_filter.hpp"
 
 namespace dacin::geom{
 
@@ -96,7 +97,7 @@ public:
 
     template<size_t m>
     int comp_angular_180(Point<m> const&o) const {
-        return o.cross(*this).sign();
+        return sign_of_det2(o.x, o.y, x, y);
     }
     template<size_t m, size_t k = n+m>
     int comp_angular_360(Point<m> const&o) const {
@@ -154,17 +155,217 @@ struct Dacin_Hash<Point<n> > {
 #endif // DACIN_HASH_HPP
 
 template<size_t n>
-int ccw(Point<n> const&a, Point<n> const&b, Point<n> const&c){
+int ccw_floating_filter(Point<n> const&a, Point<n> const&b, Point<n> const&c, std::true_type){
+    // coordinates are exact in double
+    const double ax = static_cast<double>(a.x), ay = static_cast<double>(a.y);
+    const double detleft = (static_cast<double>(b.x) - ax) * (static_cast<double>(c.y) - ay);
+    const double detright = (static_cast<double>(b.y) - ay) * (static_cast<double>(c.x) - ax);
+    return filtered_sign(detleft - detright, CCW_ERRBOUND_EXACT_INPUT * (std::abs(detleft) + std::abs(detright)));
+}
+template<size_t n>
+int ccw_floating_filter(Point<n> const&a, Point<n> const&b, Point<n> const&c, std::false_type){
+    // coordinates are rounded, so the error depends on their magnitude rather than on their differences
+    static constexpr double errbound = ccw_errbound_rounded_input(float_conversion_error(n));
+    const double ax = static_cast<double>(a.x), ay = static_cast<double>(a.y);
+    const double bx = static_cast<double>(b.x), by = static_cast<double>(b.y);
+    const double cx = static_cast<double>(c.x), cy = static_cast<double>(c.y);
+    const double det = (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+    const double mag = (std::abs(ax) + std::abs(bx)) * (std::abs(ay) + std::abs(cy)) + (std::abs(ay) + std::abs(by)) * (std::abs(ax) + std::abs(cx));
+    return filtered_sign(det, errbound * mag);
+}
+
+template<size_t n>
+int ccw_exact(Point<n> const&a, Point<n> const&b, Point<n> const&c){
     return - (b-a).comp_angular_180(c-a);
 }
+template<size_t n>
+int ccw_impl(Point<n> const&a, Point<n> const&b, Point<n> const&c, std::true_type){
+    return ccw_exact(a, b, c);
+}
+template<size_t n>
+int ccw_impl(Point<n> const&a, Point<n> const&b, Point<n> const&c, std::false_type){
+    const int ret = ccw_floating_filter(a, b, c, integral_constant<bool, n <= 53>{});
+    return ret != UNCERTAIN_SIGN ? ret : ccw_exact(a, b, c);
+}
+/// 1: counter-clockwise, 0: collinear, -1: clockwise
+/// Filtered in double unless the exact cross product fits into a native integer.
+template<size_t n>
+int ccw(Point<n> const&a, Point<n> const&b, Point<n> const&c){
+    return ccw_impl(a, b, c, integral_constant<bool, Adaptive_Int<2*n+3>::has_native_backend>{});
+}
+
+
+#ifndef DACIN_RADIX_SORT_CUTOFF
+/// shorter ranges are sorted with std::sort, see benchmark_sort_lexicographical
+#define DACIN_RADIX_SORT_CUTOFF 256
+#endif // DACIN_RADIX_SORT_CUTOFF
+#ifndef DACIN_RADIX_SORT_BITS
+/// digit width of radix_sort_by
+#define DACIN_RADIX_SORT_BITS 11
+#endif // DACIN_RADIX_SORT_BITS
 
+/// scratch memory of radix_sort_by, can be reused to avoid allocations
+template<typename T>
+struct Radix_Sort_Buffer{
+    std::vector<T> buffer;
+    std::vector<std::array<size_t, size_t{1}<<DACIN_RADIX_SORT_BITS> > count;
+};
+
+/**
+ *  Stable LSD radix sort of [first, last) by the integer coord(e)
+ *  The keys are coord(e) - min, so only the digits needed for the range of the values are sorted.
+ *  Returns false without sorting if that range does not fit into 64 bits.
+ */
+template<typename It, typename Coord>
+bool radix_sort_by(It first, It last, Coord coord, Radix_Sort_Buffer<typename std::iterator_traits<It>::value_type> &scratch){
+    using value_t = typename std::iterator_traits<It>::value_type;
+    constexpr size_t BITS = DACIN_RADIX_SORT_BITS, MASK = (size_t{1}<<BITS) - 1;
+    const size_t N = last - first;
+    if(N < 2) return true;
+    auto const bounds = std::minmax_element(first, last, [&](value_t const&a, value_t const&b){return coord(a) < coord(b);});
+    auto const range = coord(*bounds.second) - coord(*bounds.first);
+    if constexpr(!is_integral_v<typename decltype(range)::backend_t>){
+        if((range >> 32 >> 32).sign() > 0) return false;
+    }
+    // unsigned arithmetic gives the exact difference, as it is less than 2^64
+    const uint64_t offset = low_word(coord(*bounds.first));
+    auto key = [&](value_t const&e){return low_word(coord(e)) - offset;};
+    const size_t digits = std::__lg(low_word(range) | 1) / BITS + 1;
+    auto &count = scratch.count;
+    count.assign(digits, {});
+    for(It it = first;it != last;++it){
+        const uint64_t k = key(*it);
+        for(size_t d=0;d<digits;++d) ++count[d][(k >> (BITS*d)) & MASK];
+    }
+    auto &buffer = scratch.buffer;
+    buffer.resize(N);
+    bool in_buffer = false;
+    // taken before the passes, which leave moved-from elements behind
+    const uint64_t first_key = key(*first);
+    for(size_t d=0;d<digits;++d){
+        // all values have the same digit
+        if(count[d][(first_key >> (BITS*d)) & MASK] == N) continue;
+        size_t sum = 0;
+        for(auto &e:count[d]){
+            sum+= e;
+            e = sum - e;
+        }
+        if(in_buffer){
+            for(auto &e:buffer) first[count[d][(key(e) >> (BITS*d)) & MASK]++] = std::move(e);
+        } else {
+            for(It it = first;it != last;++it) buffer[count[d][(key(*it) >> (BITS*d)) & MASK]++] = std::move(*it);
+        }
+        in_buffer = !in_buffer;
+    }
+    if(in_buffer) std::move(buffer.begin(), buffer.end(), first);
+    return true;
+}
+/**
+ *  Sorts [first, last) by the lexicographical order of the points key(e)
+ *  Radix sorts by x, then the runs of equal x by y.
+ *  Falls back to std::sort for short ranges and for coordinates spanning more than 64 bits.
+ */
+template<typename It, typename Key>
+void radix_sort_lexicographical(It first, It last, Key key, Radix_Sort_Buffer<typename std::iterator_traits<It>::value_type> &scratch){
+    using value_t = typename std::iterator_traits<It>::value_type;
+    auto less = [&](value_t const&a, value_t const&b){return key(a).comp_lexicographical(key(b)) < 0;};
+    auto get_x = [&](value_t const&e) -> auto const& {return key(e).x;};
+    auto get_y = [&](value_t const&e) -> auto const& {return key(e).y;};
+    if(last - first < DACIN_RADIX_SORT_CUTOFF || !radix_sort_by(first, last, get_x, scratch)){
+        std::sort(first, last, less);
+        return;
+    }
+    for(It l = first, r;l != last;l = r){
+        for(r = l+1;r != last && get_x(*r) == get_x(*l);++r);
+        if(r - l < DACIN_RADIX_SORT_CUTOFF || !radix_sort_by(l, r, get_y, scratch)){
+            std::sort(l, r, less);
+        }
+    }
+}
+template<typename It, typename Key>
+void radix_sort_lexicographical(It first, It last, Key key){
+    Radix_Sort_Buffer<typename std::iterator_traits<It>::value_type> scratch;
+    radix_sort_lexicographical(first, last, key, scratch);
+}
+/// sorts by x, then y
+template<size_t n>
+void sort_lexicographical(std::vector<Point<n> > &pts, Radix_Sort_Buffer<Point<n> > &scratch){
+    radix_sort_lexicographical(pts.begin(), pts.end(), [](Point<n> const&p) -> Point<n> const& {return p;}, scratch);
+}
+template<size_t n>
+void sort_lexicographical(std::vector<Point<n> > &pts){
+    Radix_Sort_Buffer<Point<n> > scratch;
+    sort_lexicographical(pts, scratch);
+}
+
+/// convex_hull policies, whether to discard interior points before sorting
+struct Hull_No_Filter{};
+struct Hull_Octagon_Filter{};
+
+/**
+ *  Akl-Toussaint heuristic, removes the points strictly inside the octagon
+ *  spanned by the extreme points in the directions of x, y, x+y and x-y.
+ *  Keeps all hull vertices, returns the number of removed points.
+ */
+template<size_t n>
+size_t octagon_filter(std::vector<Point<n> > &pts){
+    if(pts.empty()) return 0;
+    // extreme points by increasing angle of the direction, so they are in ccw order
+    auto keys = [](Point<n> const&p){
+        return std::array<Adaptive_Int<n+1>, 4>{Adaptive_Int<n+1>(-p.y), p.x - p.y, Adaptive_Int<n+1>(p.x), p.x + p.y};
+    };
+    std::array<size_t, 8> extreme{};
+    const auto first = keys(pts[0]);
+    std::array<Adaptive_Int<n+1>, 8> best;
+    for(int dir=0;dir<8;++dir) best[dir] = first[dir%4];
+    for(size_t i=1;i<pts.size();++i){
+        const auto k = keys(pts[i]);
+        for(int dir=0;dir<8;++dir){
+            const int c = k[dir%4].comp(best[dir]);
+            if(dir < 4 ? c > 0 : c < 0){
+                best[dir] = k[dir%4];
+                extreme[dir] = i;
+            }
+        }
+    }
+    std::array<Point<n>, 8> octagon;
+    size_t m = 0;
+    for(size_t e:extreme){
+        if(m == 0 || (octagon[m-1] != pts[e] && octagon[0] != pts[e])) octagon[m++] = pts[e];
+    }
+    if(m < 3) return 0;
+    const size_t old_size = pts.size();
+    pts.erase(std::remove_if(pts.begin(), pts.end(), [&](Point<n> const&p){
+        for(size_t i=0;i<m;++i){
+            if(ccw(octagon[i], octagon[(i+1)%m], p) <= 0) return false;
+        }
+        return true;
+    }), pts.end());
+    return old_size - pts.size();
+}
+template<size_t n>
+void hull_prefilter(std::vector<Point<n> > &, Hull_No_Filter){}
+template<size_t n>
+void hull_prefilter(std::vector<Point<n> > &pts, Hull_Octagon_Filter){
+    octagon_filter(pts);
+}
 
+/// buffers of convex_hull, reusing them avoids allocations once they are large enough
 template<size_t n>
-std::vector<Point<n>> convex_hull(std::vector<Point<n> > pts){
-    std::sort(pts.begin(), pts.end(), [](Point<n> const&a, Point<n> const&b){return a.comp_lexicographical(b) < 0;});
+struct Convex_Hull_Workspace{
+    std::vector<Point<n> > points, hull;
+    Radix_Sort_Buffer<Point<n> > sort_buffer;
+};
+/// hull of ws.points into ws.hull, destroys ws.points
+template<size_t n, typename Filter>
+void convex_hull_impl(Convex_Hull_Workspace<n> &ws, Filter filter){
+    auto &pts = ws.points;
+    auto &hull = ws.hull;
+    hull_prefilter(pts, filter);
+    sort_lexicographical(pts, ws.sort_buffer);
     pts.erase(std::unique(pts.begin(), pts.end(), [](Point<n> const&a, Point<n> const&b){return a.comp_lexicographical(b) == 0;}), pts.end());
 
-    std::vector<Point<n>> hull;
+    hull.clear();
     for(size_t it=0;it<2;++it){
         const size_t old_size = hull.size();
         for(auto const&e:pts){
@@ -176,9 +377,65 @@ std::vector<Point<n>> convex_hull(std::vector<Point<n> > pts){
         if(hull.size() > 1) hull.pop_back();
         reverse(pts.begin(), pts.end());
     }
-    return hull;
 }
 
+/// counter-clockwise hull vertices without collinear points, starting at the lexicographically smallest one
+template<size_t n, typename Filter = Hull_No_Filter>
+std::vector<Point<n>> convex_hull(std::vector<Point<n> > pts, Filter filter = Filter{}){
+    Convex_Hull_Workspace<n> ws;
+    ws.points = std::move(pts);
+    convex_hull_impl(ws, filter);
+    return std::move(ws.hull);
+}
+/**
+ *  Same as above, for the points in [first, last)
+ *  Writes the hull to out and returns the end of the output.
+ *  Does not allocate if ws is reused and has seen at least as many points before.
+ */
+template<size_t n, typename It, typename Out, typename Filter = Hull_No_Filter>
+Out convex_hull(It first, It last, Out out, Convex_Hull_Workspace<n> &ws, Filter filter = Filter{}){
+    ws.points.assign(first, last);
+    convex_hull_impl(ws, filter);
+    return std::copy(ws.hull.begin(), ws.hull.end(), out);
+}
+/**
+ *  Hulls of the point sets pts[begin[i], begin[i+1]) for i+1 < begin.size()
+ *  The i-th hull is written to hulls[hull_begin[i], hull_begin[i+1]), both are overwritten.
+ *  Reusing the output vectors and ws, no allocations happen in the steady state.
+ */
+template<size_t n, typename Filter = Hull_No_Filter>
+void convex_hulls(std::vector<Point<n> > const&pts, std::vector<size_t> const&begin, std::vector<Point<n> > &hulls, std::vector<size_t> &hull_begin, Convex_Hull_Workspace<n> &ws, Filter filter = Filter{}){
+    hulls.clear();
+    hull_begin.clear();
+    hull_begin.push_back(0);
+    for(size_t i=0;i+1<begin.size();++i){
+        ws.points.assign(pts.begin() + begin[i], pts.begin() + begin[i+1]);
+        convex_hull_impl(ws, filter);
+        hulls.insert(hulls.end(), ws.hull.begin(), ws.hull.end());
+        hull_begin.push_back(hulls.size());
+    }
+}
+
+/**
+ *  Same result as convex_hull, on thread_cnt threads
+ *  The input is split into chunks, whose hulls are computed in parallel.
+ *  The hull of the union of their vertices is the hull of all points.
+ */
+template<size_t n, typename Filter = Hull_No_Filter>
+std::vector<Point<n>> convex_hull_parallel(std::vector<Point<n> > const&pts, size_t thread_cnt, Filter filter = Filter{}){
+    if(thread_cnt <= 1) return convex_hull(pts, filter);
+    std::vector<std::vector<Point<n> > > partial(thread_cnt);
+    std::vector<std::thread> threads;
+    for(size_t i=0;i<thread_cnt;++i){
+        threads.emplace_back([&, i](){
+            partial[i] = convex_hull(std::vector<Point<n> >(pts.begin() + pts.size()*i/thread_cnt, pts.begin() + pts.size()*(i+1)/thread_cnt), filter);
+        });
+    }
+    for(auto &e:threads) e.join();
+    std::vector<Point<n> > merged;
+    for(auto const&e:partial) merged.insert(merged.end(), e.begin(), e.end());
+    return convex_hull(std::move(merged));
+}
 
 template<size_t n, size_t m, size_t k = max(n, m)+1>
 std::vector<Point<k> > minkowski_sum(std::vector<Point<n>> a, std::vector<Point<m> > b){
@@ -235,13 +492,77 @@ bool segments_intersect(std::pair<Point<n>, Point<n> > const&s, std::pair<Point<
         && ccw(t.first, t.second, s.first) * ccw(t.first, t.second, s.second) <= 0;
 }
 
-/// 1: inside, 0: ontop, -1: outside
+/// stage of a filtered predicate that decided the result
+enum class Predicate_Stage{
+    STATIC_FILTER,
+    DYNAMIC_FILTER,
+    EXACT,
+};
+
+/// error bound of incircle_det_sign in double if all coordinates are bounded by 2^n
 template<size_t n>
-int is_in_circumcircle(Point<n> const&a, Point<n> const&b, Point<n> const&c, Point<n> const&x){
+constexpr double incircle_static_errbound(){
+    // the worst case would overflow, the filter can't succeed anyway
+    if(4*n+8 > 1000) return std::numeric_limits<double>::infinity();
+    const Float_Error coord = Float_Error::input(n);
+    const Float_Error diff = coord - coord;
+    const Float_Error cross = diff * diff - diff * diff, norm = diff * diff + diff * diff;
+    const Float_Error term = cross * norm;
+    return (term + term + term).bound();
+}
+
+template<size_t n>
+int incircle_det_sign_exact(Point<n> const&a, Point<n> const&b, Point<n> const&c, Point<n> const&x){
     auto const A = a-x, B = b-x, C = c-x;
     auto const X = A.norm_sq(), Y = B.norm_sq(), Z = C.norm_sq();
     auto det = A.cross(B)*Z + B.cross(C)*X + C.cross(A)*Y;
-    return det.sign() * ccw(a, b, c);
+    return det.sign();
+}
+template<size_t n>
+std::pair<int, Predicate_Stage> incircle_det_sign(Point<n> const&a, Point<n> const&b, Point<n> const&c, Point<n> const&x, std::true_type){
+    return std::make_pair(incircle_det_sign_exact(a, b, c, x), Predicate_Stage::EXACT);
+}
+template<size_t n>
+std::pair<int, Predicate_Stage> incircle_det_sign(Point<n> const&a, Point<n> const&b, Point<n> const&c, Point<n> const&x, std::false_type){
+    static constexpr double static_errbound = incircle_static_errbound<n>();
+    const double ax = static_cast<double>(a.x), ay = static_cast<double>(a.y);
+    const double bx = static_cast<double>(b.x), by = static_cast<double>(b.y);
+    const double cx = static_cast<double>(c.x), cy = static_cast<double>(c.y);
+    const double xx = static_cast<double>(x.x), xy = static_cast<double>(x.y);
+    {
+        // semi-static filter, the bound only depends on n
+        const double Ax = ax - xx, Ay = ay - xy, Bx = bx - xx, By = by - xy, Cx = cx - xx, Cy = cy - xy;
+        const double det = (Ax * By - Ay * Bx) * (Cx * Cx + Cy * Cy)
+                         + (Bx * Cy - By * Cx) * (Ax * Ax + Ay * Ay)
+                         + (Cx * Ay - Cy * Ax) * (Bx * Bx + By * By);
+        const int ret = filtered_sign(det, static_errbound);
+        if(ret != UNCERTAIN_SIGN) return std::make_pair(ret, Predicate_Stage::STATIC_FILTER);
+    }
+    {
+        // dynamic filter, interval arithmetic
+        auto iv = [](double val){return Interval::with_relative_error(val, float_conversion_error(n));};
+        const Interval X = iv(xx), Y = iv(xy);
+        const Interval Ax = iv(ax) - X, Ay = iv(ay) - Y, Bx = iv(bx) - X, By = iv(by) - Y, Cx = iv(cx) - X, Cy = iv(cy) - Y;
+        const Interval det = (Ax * By - Ay * Bx) * (Cx * Cx + Cy * Cy)
+                           + (Bx * Cy - By * Cx) * (Ax * Ax + Ay * Ay)
+                           + (Cx * Ay - Cy * Ax) * (Bx * Bx + By * By);
+        const int ret = det.sign();
+        if(ret != UNCERTAIN_SIGN) return std::make_pair(ret, Predicate_Stage::DYNAMIC_FILTER);
+    }
+    return std::make_pair(incircle_det_sign_exact(a, b, c, x), Predicate_Stage::EXACT);
+}
+
+/// same as is_in_circumcircle, also returns the stage that decided the sign of the incircle determinant
+template<size_t n>
+std::pair<int, Predicate_Stage> is_in_circumcircle_staged(Point<n> const&a, Point<n> const&b, Point<n> const&c, Point<n> const&x){
+    auto ret = incircle_det_sign(a, b, c, x, integral_constant<bool, Adaptive_Int<4*n+8>::has_native_backend>{});
+    ret.first*= ccw(a, b, c);
+    return ret;
+}
+/// 1: inside, 0: ontop, -1: outside
+template<size_t n>
+int is_in_circumcircle(Point<n> const&a, Point<n> const&b, Point<n> const&c, Point<n> const&x){
+    return is_in_circumcircle_staged(a, b, c, x).first;
 }
 
 
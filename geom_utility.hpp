@@ -6,6 +6,10 @@
 
 #include <bits/stdc++.h>
 
+#if defined(__SIZEOF_INT128__) && !defined(HAS_INT128) && !defined(DACIN_NO_INT128)
+#define HAS_INT128
+#endif // __SIZEOF_INT128__
+
 namespace dacin::geom{
 
 using std::integral_constant;
@@ -44,6 +48,63 @@ using std::is_same_v;
 #endif // __cplusplus
 
 
+#ifdef HAS_INT128
+// iostreams have no overloads for __int128
+std::ostream& operator<<(std::ostream&o, __int128 const&val){
+    unsigned __int128 tmp = val < 0 ? -static_cast<unsigned __int128>(val) : val;
+    char buf[41], *pos = buf + sizeof(buf);
+    *--pos = 0;
+    do{
+        *--pos = '0' + static_cast<int>(tmp % 10);
+        tmp/=10;
+    } while(tmp);
+    if(val < 0) *--pos = '-';
+    return o << pos;
+}
+// parses like the overload for long long: an optional sign and at least one digit, sets failbit otherwise or on overflow
+std::istream& operator>>(std::istream&in, __int128 &val){
+    std::istream::sentry sentry(in);
+    if(!sentry) return in;
+    int c = in.peek();
+    const bool nega = c == '-';
+    if(c == '-' || c == '+'){
+        in.get();
+        c = in.peek();
+    }
+    if(!std::isdigit(c)){
+        val = 0;
+        in.setstate(std::ios::failbit);
+        return in;
+    }
+    const unsigned __int128 lim = (~static_cast<unsigned __int128>(0) >> 1) + nega;
+    unsigned __int128 tmp = 0;
+    bool overflow = false;
+    do{
+        const unsigned digit = in.get() - '0';
+        if(tmp > (lim - digit) / 10) overflow = true;
+        else tmp = tmp*10 + digit;
+    } while(std::isdigit(in.peek()));
+    if(overflow){
+        tmp = lim;
+        in.setstate(std::ios::failbit);
+    }
+    val = nega ? -tmp : tmp;
+    return in;
+}
+#endif // HAS_INT128
+
+
+/// calls f(integral_constant<size_t, i>{}) for i = 0, ..., n-1, unrolled at compile time
+template<typename F, size_t... i>
+void static_for_impl(F&& f, std::index_sequence<i...>){
+    (f(integral_constant<size_t, i>{}), ...);
+}
+template<size_t n, typename F>
+void static_for(F&& f){
+    static_for_impl(f, std::make_index_sequence<n>{});
+}
+
+
 template<size_t n>
 struct Priority : Priority<n-1> {};
 template<>
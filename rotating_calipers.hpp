@@ -0,0 +1,159 @@
+// Released under GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007, see the LICENSE file.
+// Copyright (C) 2018-2019 Daniel Rutschmann aka. dacin21
+
+#ifndef ROTATING_CALIPERS_HPP
+#define ROTATING_CALIPERS_HPP
+
+#include "geom_2d.hpp"
+
+namespace dacin::geom{
+
+/// the rational number num / den, den is positive
+template<size_t k, size_t l>
+struct Fraction{
+    Adaptive_Int<k> num;
+    Adaptive_Int<l> den;
+
+    int comp(Fraction const&o) const {
+        return compare_products(num, o.den, o.num, den);
+    }
+    explicit operator double() const {
+        return static_cast<double>(num) / static_cast<double>(den);
+    }
+};
+template<size_t k, size_t l>
+Fraction<k, l> make_fraction(Adaptive_Int<k> const&num, Adaptive_Int<l> const&den){
+    return Fraction<k, l>{num, den};
+}
+
+/**
+ *  Calls f(i, j) for every antipodal pair of vertices of hull, as returned by convex_hull, in O(h)
+ *  Two vertices are antipodal if they lie on two parallel supporting lines.
+ *  Each unordered pair is reported once, there are at most 3h/2 of them.
+ */
+template<size_t n, typename F>
+void for_each_antipodal_pair(std::vector<Point<n> > const&hull, F&& f){
+    const size_t h = hull.size();
+    if(h <= 2){
+        if(h) f(0, h-1);
+        return;
+    }
+    // both calipers start vertical, the hull goes down on the left and up on the right
+    const size_t last = std::max_element(hull.begin(), hull.end(), [](Point<n> const&a, Point<n> const&b){return a.comp_lexicographical(b) < 0;}) - hull.begin();
+    size_t i = 0, j = last;
+    while(i < last || j < h){
+        f(i, j % h);
+        if(i == last){
+            ++j;
+        } else if(j == h){
+            ++i;
+        } else {
+            // rotate to whichever edge comes first, on parallel edges both pairs across are antipodal
+            const int c = (hull[i+1] - hull[i]).cross(hull[(j+1)%h] - hull[j]).sign();
+            if(c == 0) f(i, (j+1) % h);
+            if(c <= 0) ++i;
+            else ++j;
+        }
+    }
+}
+template<size_t n>
+std::vector<std::array<size_t, 2> > antipodal_pairs(std::vector<Point<n> > const&hull){
+    std::vector<std::array<size_t, 2> > ret;
+    for_each_antipodal_pair(hull, [&](size_t i, size_t j){ret.push_back({i, j});});
+    return ret;
+}
+
+/// a farthest pair of vertices of hull and their squared distance, the hull must not be empty
+template<size_t n, size_t k = 2*n+3>
+std::pair<Adaptive_Int<k>, std::array<size_t, 2> > diameter(std::vector<Point<n> > const&hull){
+    assert(!hull.empty());
+    std::pair<Adaptive_Int<k>, std::array<size_t, 2> > ret(Adaptive_Int<k>(0), {0, 0});
+    for_each_antipodal_pair(hull, [&](size_t i, size_t j){
+        auto const d = (hull[i] - hull[j]).norm_sq();
+        if(d > ret.first) ret = {d, {i, j}};
+    });
+    return ret;
+}
+
+/// rectangle with a side on the hull edge from edge to edge+1, touching the other vertices on the other sides
+struct Calipers_Rectangle{
+    size_t edge, left, top, right;
+};
+
+/**
+ *  Calls f(r) for each edge of hull, as returned by convex_hull with at least 2 vertices, in O(h)
+ *  r.top is the vertex farthest from the edge, r.left and r.right minimize and maximize the projection onto it.
+ *  The ties are broken by the first vertex in counter-clockwise order, starting after the edge.
+ */
+template<size_t n, typename F>
+void rotating_calipers(std::vector<Point<n> > const&hull, F&& f){
+    const size_t h = hull.size();
+    assert(h >= 2);
+    auto side = [&](size_t i){return hull[(i+1)%h] - hull[i%h];};
+    // all three only move forward
+    size_t left = 0, top = 0, right = 1;
+    for(size_t i=0;i<h;++i){
+        auto const e = side(i);
+        while(e.dot(side(right)).sign() > 0) ++right;
+        if(i == 0) top = right;
+        while(e.cross(side(top)).sign() > 0) ++top;
+        if(i == 0) left = top;
+        while(e.dot(side(left)).sign() < 0) ++left;
+        f(Calipers_Rectangle{i, left % h, top % h, right % h});
+    }
+}
+
+/// the minimum distance between two parallel supporting lines, squared, and the edge and vertex they touch
+template<size_t n>
+auto width_sq(std::vector<Point<n> > const&hull){
+    auto value = [&](Calipers_Rectangle const&r){
+        auto const e = hull[(r.edge+1)%hull.size()] - hull[r.edge];
+        auto const height = e.cross(hull[r.top] - hull[r.edge]);
+        return make_fraction(height * height, e.norm_sq());
+    };
+    std::pair<decltype(value(declval<Calipers_Rectangle>())), std::array<size_t, 2> > ret;
+    rotating_calipers(hull, [&](Calipers_Rectangle const&r){
+        auto const cand = value(r);
+        if(r.edge == 0 || cand.comp(ret.first) < 0) ret = {cand, {r.edge, r.top}};
+    });
+    return ret;
+}
+
+/**
+ *  The enclosing rectangle of minimum area or perimeter, it has a side on an edge of the hull
+ *  Returns the exact area or the squared perimeter and the rectangle,
+ *  its corners are the projections of the touching vertices onto the lines through the sides.
+ */
+template<size_t n>
+auto min_area_rectangle(std::vector<Point<n> > const&hull){
+    auto value = [&](Calipers_Rectangle const&r){
+        auto const e = hull[(r.edge+1)%hull.size()] - hull[r.edge];
+        return make_fraction(e.cross(hull[r.top] - hull[r.edge]) * e.dot(hull[r.right] - hull[r.left]), e.norm_sq());
+    };
+    std::pair<decltype(value(declval<Calipers_Rectangle>())), Calipers_Rectangle> ret;
+    rotating_calipers(hull, [&](Calipers_Rectangle const&r){
+        auto const cand = value(r);
+        if(r.edge == 0 || cand.comp(ret.first) < 0) ret = {cand, r};
+    });
+    return ret;
+}
+template<size_t n>
+auto min_perimeter_rectangle(std::vector<Point<n> > const&hull){
+    auto value = [&](Calipers_Rectangle const&r){
+        auto const e = hull[(r.edge+1)%hull.size()] - hull[r.edge];
+        // half of the perimeter is (height + length) / |e|
+        auto const half = e.cross(hull[r.top] - hull[r.edge]) + e.dot(hull[r.right] - hull[r.left]);
+        auto const perimeter = half + half;
+        return make_fraction(perimeter * perimeter, e.norm_sq());
+    };
+    std::pair<decltype(value(declval<Calipers_Rectangle>())), Calipers_Rectangle> ret;
+    rotating_calipers(hull, [&](Calipers_Rectangle const&r){
+        auto const cand = value(r);
+        if(r.edge == 0 || cand.comp(ret.first) < 0) ret = {cand, r};
+    });
+    return ret;
+}
+
+} // namespace dacin::geom
+
+#endif // ROTATING_CALIPERS_HPP
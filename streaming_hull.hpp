@@ -0,0 +1,127 @@
+// Released under GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007, see the LICENSE file.
+// Copyright (C) 2018-2019 Daniel Rutschmann aka. dacin21
+
+#ifndef STREAMING_HULL_HPP
+#define STREAMING_HULL_HPP
+
+#include "geom_2d.hpp"
+
+#if __has_include(<unistd.h>)
+#include <unistd.h>
+#define DACIN_HAS_POSIX_READ
+#endif
+
+namespace dacin::geom{
+
+/**
+ *  Convex hull of a stream of points, without storing all of them
+ *  Points are buffered behind the hull of the points before, once the buffer is full
+ *  the hull of both replaces it. The buffer holds at most max(chunk_size, h) points on
+ *  top of the h hull vertices, so each point is sorted O(1) times amortized.
+ *  The result is the same as convex_hull on all points, as the hull of a union is the
+ *  hull of the union of the hulls.
+ */
+template<size_t n, typename Filter = Hull_Octagon_Filter>
+class Streaming_Hull{
+public:
+    using point_t = Point<n>;
+
+    explicit Streaming_Hull(size_t chunk_size_ = 1<<16) : chunk_size(std::max<size_t>(1, chunk_size_)) {}
+
+    /// adds the points in [first, last), also works on memory mapped records
+    template<typename It>
+    void add(It first, It last){
+        for(;first != last;++first){
+            ws.points.push_back(*first);
+            if(ws.points.size() >= hull_size + std::max(chunk_size, hull_size)) merge();
+        }
+    }
+    void add(point_t const&p){
+        add(&p, &p + 1);
+    }
+    /// the hull of all points added so far, same as convex_hull
+    std::vector<point_t> const& get_hull(){
+        if(ws.points.size() > hull_size) merge();
+        return ws.hull;
+    }
+    size_t get_chunk_size() const {
+        return chunk_size;
+    }
+
+private:
+    /// the running hull is always the prefix ws.points[0, hull_size)
+    void merge(){
+        convex_hull_impl(ws, Filter{});
+        ws.points.assign(ws.hull.begin(), ws.hull.end());
+        hull_size = ws.hull.size();
+    }
+
+    size_t chunk_size;
+    size_t hull_size = 0;
+    Convex_Hull_Workspace<n> ws;
+};
+
+/**
+ *  Reads raw Point<n> records until the end of in, in chunks of h.get_chunk_size() points
+ *  The records are the in-memory representation, as written by out.write(data, size * sizeof(Point<n>)).
+ *  Returns false on a read error, which sets badbit, or if the stream ends within a record.
+ */
+template<size_t n, typename Filter>
+bool add_records(Streaming_Hull<n, Filter> &h, std::istream &in){
+    static_assert(std::is_trivially_copyable_v<Point<n> >);
+    std::vector<Point<n> > buffer(h.get_chunk_size());
+    while(in){
+        in.read(reinterpret_cast<char*>(buffer.data()), buffer.size() * sizeof(Point<n>));
+        const size_t bytes = in.gcount();
+        h.add(buffer.begin(), buffer.begin() + bytes / sizeof(Point<n>));
+        if(bytes % sizeof(Point<n>)) return false;
+    }
+    return !in.bad();
+}
+/// hull of all records in in, std::nullopt on a read error or if the stream ends within a record
+template<size_t n, typename Filter = Hull_Octagon_Filter>
+std::optional<std::vector<Point<n> > > convex_hull_stream(std::istream &in, size_t chunk_size = 1<<16){
+    Streaming_Hull<n, Filter> h(chunk_size);
+    if(!add_records(h, in)) return std::nullopt;
+    return h.get_hull();
+}
+
+#ifdef DACIN_HAS_POSIX_READ
+/**
+ *  Same as above, reading from the file descriptor fd with read()
+ *  Returns false on a read error or if the file ends within a record.
+ */
+template<size_t n, typename Filter>
+bool add_records(Streaming_Hull<n, Filter> &h, int fd){
+    static_assert(std::is_trivially_copyable_v<Point<n> >);
+    std::vector<Point<n> > buffer(h.get_chunk_size());
+    char* const data = reinterpret_cast<char*>(buffer.data());
+    const size_t capacity = buffer.size() * sizeof(Point<n>);
+    // read() may return partial records, the rest of one is kept for the next call
+    size_t filled = 0;
+    for(;;){
+        const ssize_t got = ::read(fd, data + filled, capacity - filled);
+        if(got < 0){
+            if(errno == EINTR) continue;
+            return false;
+        }
+        if(got == 0) return filled == 0;
+        filled+= got;
+        const size_t cnt = filled / sizeof(Point<n>);
+        h.add(buffer.begin(), buffer.begin() + cnt);
+        filled-= cnt * sizeof(Point<n>);
+        std::memmove(data, data + cnt * sizeof(Point<n>), filled);
+    }
+}
+/// hull of all records in fd, std::nullopt on a read error or if the file ends within a record
+template<size_t n, typename Filter = Hull_Octagon_Filter>
+std::optional<std::vector<Point<n> > > convex_hull_stream(int fd, size_t chunk_size = 1<<16){
+    Streaming_Hull<n, Filter> h(chunk_size);
+    if(!add_records(h, fd)) return std::nullopt;
+    return h.get_hull();
+}
+#endif // DACIN_HAS_POSIX_READ
+
+} // namespace dacin::geom
+
+#endif // STREAMING_HULL_HPP
@@ -17,14 +17,16 @@ namespace dacin::geom{
         const int n = 3000;
         const int ITER = 1500;
         uint64_t ha = 0;
+        vector<Point<bits> > p(n), ret;
+        Convex_Hull_Workspace<bits> ws;
         for(int it=0;it<ITER;++it){
-            vector<Point<bits> > p(n);
             const T lim = (T{1}<<(log_lim-1)) - T{1} + (T{1}<<(log_lim-1));
             for(auto &e:p){
                 e.x = Adaptive_Int<bits>(get_rand(0, lim));
                 e.y = Adaptive_Int<bits>(get_rand(0, lim));
             }
-            auto ret = convex_hull(p);
+            ret.clear();
+            convex_hull(p.begin(), p.end(), back_inserter(ret), ws);
             ha*=12347;
             ha+=ret.size();
         }
@@ -44,12 +46,14 @@ namespace dacin::geom{
         test_hulls_square_impl<321, int>(11956885618327015784ull, 31);
         test_hulls_square_impl<32, int64_t>(16151321917681398953ull);
         test_hulls_square_impl<321, int64_t>(16151321917681398953ull, 32);
+        test_hulls_square_impl<100, int64_t>(16151321917681398953ull, 32);
         test_hulls_square_impl<61, int64_t>(4189760975843510352ull);
         test_hulls_square_impl<321, int64_t>(4189760975843510352ull, 61);
         test_hulls_square_impl<62, int64_t>(5248897970778511319ull);
         test_hulls_square_impl<321, int64_t>(5248897970778511319ull, 62);
         test_hulls_square_impl<63, int64_t>(7546482978952081156ull);
         test_hulls_square_impl<321, int64_t>(7546482978952081156ull, 63);
+        test_hulls_square_impl<127, int64_t>(7546482978952081156ull, 63);
     }
     template<size_t bits, typename T>
     void test_circumcircle_impl(uint64_t expected = 0, size_t log_lim = bits){
@@ -84,13 +88,739 @@ namespace dacin::geom{
         test_circumcircle_impl<321, int>(9294910920041591446ull, 21);
         test_circumcircle_impl<22, int>(6899345392128341650ull);
         test_circumcircle_impl<321, int>(6899345392128341650ull, 22);
+        test_circumcircle_impl<100, int>(6899345392128341650ull, 22);
         test_circumcircle_impl<62, int64_t>(2678531202223027034ull);
         test_circumcircle_impl<321, int64_t>(2678531202223027034ull, 62);
         test_circumcircle_impl<63, int64_t>(5179094771316369856ull);
         test_circumcircle_impl<321, int64_t>(5179094771316369856ull, 63);
+        test_circumcircle_impl<127, int64_t>(5179094771316369856ull, 63);
 
     }
 
+    template<size_t bits, typename T>
+    void test_ccw_filter_impl(size_t log_lim = bits){
+        cerr << "Running test test_ccw_filter " << bits << " " << log_lim << "\n";
+        mt19937 rng(100531);
+        auto get_rand = [&](T l, T r){return uniform_int_distribution<T>(l, r)(rng);};
+        const int ITER = 150000;
+        const T lim = (T{1}<<(log_lim-2)) - T{1};
+        for(int it=0;it<ITER;++it){
+            // nearly collinear points, so that the filter has to fall back
+            const T ax = get_rand(-lim, lim), ay = get_rand(-lim, lim);
+            const T dx = get_rand(-1000, 1000), dy = get_rand(-1000, 1000);
+            Point<bits> a(ax, ay), b(ax + dx, ay + dy), c(ax - dx + get_rand(-1, 1), ay - dy + get_rand(-1, 1));
+            Point<bits> e(get_rand(-lim, lim), get_rand(-lim, lim));
+            assert(ccw(a, b, c) == ccw_exact(a, b, c));
+            assert(ccw(c, a, b) == ccw_exact(c, a, b));
+            assert(ccw(a, b, e) == ccw_exact(a, b, e));
+        }
+        cerr << "Test ok\n";
+    }
+    void test_ccw_filter(){
+        test_ccw_filter_impl<40, int64_t>();
+        test_ccw_filter_impl<53, int64_t>();
+        test_ccw_filter_impl<63, int64_t>();
+        test_ccw_filter_impl<100, int64_t>(63);
+        test_ccw_filter_impl<321, int64_t>(63);
+    }
+
+    template<size_t bits, typename T>
+    void test_circumcircle_filter_impl(size_t log_lim = bits){
+        cerr << "Running test test_circumcircle_filter " << bits << " " << log_lim << "\n";
+        mt19937 rng(100531);
+        auto get_rand = [&](T l, T r){return uniform_int_distribution<T>(l, r)(rng);};
+        // lattice points on a circle of radius 5
+        const array<pair<int, int>, 12> circle{{{5, 0}, {4, 3}, {3, 4}, {0, 5}, {-3, 4}, {-4, 3}, {-5, 0}, {-4, -3}, {-3, -4}, {0, -5}, {3, -4}, {4, -3}}};
+        const int ITER = 50000;
+        const T lim = (T{1}<<(log_lim-2)) - T{1};
+        array<int, 3> stages{};
+        for(int it=0;it<ITER;++it){
+            // nearly cocircular points, so that the filters have to fall back
+            const T ox = get_rand(-lim, lim), oy = get_rand(-lim, lim), scale = get_rand(1, 1000);
+            array<Point<bits>, 4> p;
+            for(auto &e:p){
+                auto const&q = circle[get_rand(0, circle.size()-1)];
+                e = Point<bits>(ox + q.first * scale + get_rand(-1, 1), oy + q.second * scale + get_rand(-1, 1));
+            }
+            auto const ret = is_in_circumcircle_staged(p[0], p[1], p[2], p[3]);
+            assert(ret.first == incircle_det_sign_exact(p[0], p[1], p[2], p[3]) * ccw_exact(p[0], p[1], p[2]));
+            ++stages[static_cast<int>(ret.second)];
+        }
+        cerr << "static / dynamic / exact: " << stages[0] << " " << stages[1] << " " << stages[2] << "\n";
+        cerr << "Test ok\n";
+    }
+    void test_circumcircle_filter(){
+        test_circumcircle_filter_impl<20, int>();
+        test_circumcircle_filter_impl<40, int64_t>();
+        test_circumcircle_filter_impl<63, int64_t>();
+        test_circumcircle_filter_impl<321, int64_t>(63);
+    }
+
+    template<size_t bits>
+    void test_compare_products_impl(){
+        cerr << "Running test test_compare_products " << bits << "\n";
+        mt19937_64 rng(100531);
+        auto get_rand = [&](int64_t l, int64_t r){return uniform_int_distribution<int64_t>(l, r)(rng);};
+        const int ITER = 100000;
+        for(int it=0;it<ITER;++it){
+            // a*b and c*d agree in the leading words, so that the filter has to fall back
+            const Adaptive_Int<bits> x(get_rand(1, (int64_t{1}<<62)-1)), y(get_rand(1, (int64_t{1}<<62)-1));
+            const auto a = x*y*Adaptive_Int<3>(get_rand(-3, 3)), b = y*y*Adaptive_Int<3>(get_rand(-3, 3));
+            const auto c = get_rand(0, 1) ? a : -a, d = get_rand(0, 1) ? b : -b;
+            const Adaptive_Int<2> da(get_rand(-1, 1)), db(get_rand(-1, 1));
+            const auto a2 = a + da, b2 = b + db, c2 = c - db, d2 = d - da;
+            assert(compare_products(a2, b2, c2, d2) == (a2*b2).comp(c2*d2));
+            assert(sign_of_det2(a2, b2, c2, d2) == (a2*d2).comp(b2*c2));
+            // points of different widths, nearly parallel
+            const int64_t qx = get_rand(-(int64_t{1}<<39)+1, (int64_t{1}<<39)-1), qy = get_rand(-(int64_t{1}<<39)+1, (int64_t{1}<<39)-1);
+            const int64_t t = get_rand(1, int64_t{1}<<20);
+            const Point<40> q(qx, qy);
+            const Point<bits> p(qx*t + get_rand(-1, 1), qy*t + get_rand(-1, 1));
+            const int expected = (q.x*p.y).comp(p.x*q.y);
+            assert(p.comp_angular_180(q) == expected && q.comp_angular_180(p) == -expected);
+        }
+        cerr << "Test ok\n";
+    }
+    void test_compare_products(){
+        test_compare_products_impl<63>();
+        test_compare_products_impl<100>();
+    }
+
+    /// the triangles are ccw, have empty circumcircles, cover the convex hull and their neighbors match
+    template<size_t bits>
+    void check_delaunay_mesh(vector<Point<bits> > const&p, Delaunay_Mesh const&mesh){
+        Adaptive_Int<2*bits+24> area(0);
+        for(size_t i=0;i<mesh.triangles.size();++i){
+            auto const&t = mesh.triangles[i];
+            assert(ccw(p[t[0]], p[t[1]], p[t[2]]) > 0);
+            for(auto const&e:p){
+                assert(is_in_circumcircle(p[t[0]], p[t[1]], p[t[2]], e) <= 0);
+            }
+            area+= make_unsafe((p[t[1]] - p[t[0]]).cross(p[t[2]] - p[t[0]]));
+            for(int j=0;j<3;++j){
+                const uint32_t o = mesh.neighbors[i][j];
+                if(o == Delaunay_Mesh::NONE) continue;
+                const int k = find(mesh.neighbors[o].begin(), mesh.neighbors[o].end(), i) - mesh.neighbors[o].begin();
+                assert(k < 3 && mesh.triangles[o][(k+1)%3] == t[(j+2)%3] && mesh.triangles[o][(k+2)%3] == t[(j+1)%3]);
+            }
+        }
+        assert(p.size() < 3 || area == polygon_area_doubled(convex_hull(p)));
+    }
+    /// triangles of the mesh, independent of their order and rotation
+    vector<array<uint32_t, 3> > canonical_triangles(Delaunay_Mesh const&mesh){
+        vector<array<uint32_t, 3> > ret = mesh.triangles;
+        for(auto &t:ret) rotate(t.begin(), min_element(t.begin(), t.end()), t.end());
+        sort(ret.begin(), ret.end());
+        return ret;
+    }
+    template<size_t bits>
+    void test_delaunay_impl(size_t N, int64_t lim, bool collinear = false, Insertion_Order order = Insertion_Order::BRIO){
+        cerr << "Running test test_delaunay " << bits << " " << N << " " << lim << " " << static_cast<int>(order) << "\n";
+        mt19937_64 rng(100531);
+        auto get_rand = [&](int64_t l, int64_t r){return uniform_int_distribution<int64_t>(l, r)(rng);};
+        set<pair<int64_t, int64_t> > distinct;
+        while(distinct.size() < N){
+            const int64_t x = get_rand(-lim, lim);
+            distinct.emplace(x, collinear ? x : get_rand(-lim, lim));
+        }
+        vector<Point<bits> > p;
+        for(auto const&e:distinct) p.emplace_back(e.first, e.second);
+        shuffle(p.begin(), p.end(), rng);
+        Delaunay<bits> d;
+        auto const&faces = d.triangulate(p, order, rng());
+        // the finite faces have empty circumcircles and cover the convex hull
+        Adaptive_Int<2*bits+24> area(0);
+        for(auto const&f:faces){
+            if(Delaunay<bits>::is_infinite(f)) continue;
+            assert(ccw(f.corners[0], f.corners[1], f.corners[2]) > 0);
+            for(auto const&e:p){
+                assert(is_in_circumcircle(f.corners[0], f.corners[1], f.corners[2], e) <= 0);
+            }
+            area+= make_unsafe((f.corners[1] - f.corners[0]).cross(f.corners[2] - f.corners[0]));
+        }
+        assert(area == polygon_area_doubled(convex_hull(p)));
+        // the compact mesh describes the same triangles
+        auto const mesh = d.get_mesh();
+        size_t finite_cnt = 0;
+        for(auto const&f:faces) finite_cnt+= !Delaunay<bits>::is_infinite(f);
+        assert(mesh.triangles.size() == finite_cnt && mesh.neighbors.size() == finite_cnt);
+        check_delaunay_mesh(p, mesh);
+        cerr << "Test ok\n";
+    }
+    /// insertions and removals on a live triangulation give the triangulation of the remaining points
+    template<size_t bits>
+    void test_delaunay_online_impl(size_t N, int64_t lim){
+        cerr << "Running test test_delaunay_online " << bits << " " << N << " " << lim << "\n";
+        mt19937_64 rng(100531);
+        auto get_rand = [&](){return uniform_int_distribution<int64_t>(-lim, lim)(rng);};
+        Delaunay<bits> d;
+        set<pair<int64_t, int64_t> > distinct;
+        for(size_t i=0;i<N;++i) distinct.emplace(get_rand(), get_rand());
+        vector<Point<bits> > initial;
+        for(auto const&e:distinct) initial.emplace_back(e.first, e.second);
+        d.triangulate(initial);
+        vector<int> vertices(initial.size());
+        iota(vertices.begin(), vertices.end(), 0);
+        for(int round=0;round<4;++round){
+            for(size_t i=0;i<N;++i){
+                const int v = d.insert(Point<bits>(get_rand(), get_rand()));
+                if(find(vertices.begin(), vertices.end(), v) == vertices.end()) vertices.push_back(v);
+            }
+            shuffle(vertices.begin(), vertices.end(), rng);
+            for(size_t i=0;i<N/2 + round*N/4 && !vertices.empty();++i){
+                d.remove(vertices.back());
+                vertices.pop_back();
+            }
+            vector<Point<bits> > p;
+            for(int v:vertices) p.push_back(d.get_points()[v]);
+            Delaunay_Mesh mesh = d.get_mesh();
+            for(auto &t:mesh.triangles){
+                for(auto &v:t){
+                    v = find(vertices.begin(), vertices.end(), static_cast<int>(v)) - vertices.begin();
+                    assert(v < vertices.size());
+                }
+            }
+            check_delaunay_mesh(p, mesh);
+        }
+        cerr << "Test ok\n";
+    }
+    void test_delaunay(){
+        test_delaunay_impl<30>(300, (1<<29)-1);
+        test_delaunay_impl<30>(500, 15);
+        test_delaunay_impl<30>(50, 1000, true);
+        test_delaunay_impl<30>(500, 15, false, Insertion_Order::INPUT);
+        test_delaunay_impl<30>(500, 15, false, Insertion_Order::RANDOM);
+        test_delaunay_impl<30>(500, 15, false, Insertion_Order::HILBERT);
+        test_delaunay_impl<62>(300, (int64_t{1}<<61)-1);
+        test_delaunay_impl<100>(300, 1000);
+        test_delaunay_online_impl<30>(200, (1<<29)-1);
+        test_delaunay_online_impl<30>(200, 10);
+        test_delaunay_online_impl<62>(100, (int64_t{1}<<61)-1);
+    }
+
+    /// moving the points of a triangulation gives the triangulation of the moved points
+    template<size_t bits>
+    void test_delaunay_move_impl(size_t N, int64_t lim, int64_t step){
+        cerr << "Running test test_delaunay_move " << bits << " " << N << " " << lim << " " << step << "\n";
+        mt19937_64 rng(100531);
+        auto get_rand = [&](int64_t l, int64_t r){return uniform_int_distribution<int64_t>(l, r)(rng);};
+        set<pair<int64_t, int64_t> > distinct;
+        while(distinct.size() < N) distinct.emplace(get_rand(-lim, lim), get_rand(-lim, lim));
+        vector<pair<int64_t, int64_t> > coords(distinct.begin(), distinct.end());
+        vector<Point<bits> > p;
+        for(auto const&e:coords) p.emplace_back(e.first, e.second);
+        Delaunay<bits> d;
+        d.triangulate(p);
+        size_t reinserted = 0;
+        for(int round=0;round<5;++round){
+            set<pair<int64_t, int64_t> > moved;
+            for(auto &e:coords){
+                do{
+                    e.first+= get_rand(-step, step);
+                    e.second+= get_rand(-step, step);
+                } while(!moved.emplace(e).second);
+            }
+            for(size_t i=0;i<N;++i) p[i] = Point<bits>(coords[i].first, coords[i].second);
+            reinserted+= d.move_points(p).reinserted;
+            const Delaunay_Mesh mesh = d.get_mesh();
+            check_delaunay_mesh(p, mesh);
+            assert(canonical_triangles(mesh) == canonical_triangles(Delaunay<bits>().triangulate_mesh(p)));
+        }
+        // large steps have to invert some triangles
+        assert(step < lim / 20 || reinserted > 0);
+        cerr << "Test ok\n";
+    }
+    void test_delaunay_move(){
+        test_delaunay_move_impl<30>(500, 1<<20, 1<<8);
+        test_delaunay_move_impl<30>(500, 1<<20, 1<<16);
+        test_delaunay_move_impl<62>(300, int64_t{1}<<40, int64_t{1}<<38);
+    }
+    /// compares the minimum spanning tree and nearest neighbors with a quadratic brute force
+    template<size_t bits>
+    void test_delaunay_graphs_impl(size_t N, int64_t lim, bool collinear = false){
+        cerr << "Running test test_delaunay_graphs " << bits << " " << N << " " << lim << "\n";
+        mt19937_64 rng(100531);
+        auto get_rand = [&](){return uniform_int_distribution<int64_t>(-lim, lim)(rng);};
+        set<pair<int64_t, int64_t> > distinct;
+        while(distinct.size() < N){
+            const int64_t x = get_rand();
+            distinct.emplace(x, collinear ? 3*x : get_rand());
+        }
+        vector<Point<bits> > p;
+        for(auto const&e:distinct) p.emplace_back(e.first, e.second);
+        shuffle(p.begin(), p.end(), rng);
+        auto dist = [&](int a, int b){return (p[a] - p[b]).norm_sq();};
+        using dist_t = decltype(dist(0, 0));
+        // Prim, the sorted edge lengths are the same for every minimum spanning tree
+        vector<dist_t> expected, got;
+        vector<bool> in_tree(N, false);
+        vector<dist_t> best(N, dist(0, 0));
+        in_tree[0] = true;
+        for(size_t i=1;i<N;++i) best[i] = dist(0, i);
+        for(size_t it=1;it<N;++it){
+            int next = -1;
+            for(size_t i=0;i<N;++i){
+                if(!in_tree[i] && (next == -1 || best[i] < best[next])) next = i;
+            }
+            in_tree[next] = true;
+            expected.push_back(best[next]);
+            for(size_t i=0;i<N;++i){
+                if(!in_tree[i] && dist(next, i) < best[i]) best[i] = dist(next, i);
+            }
+        }
+        const auto tree = euclidean_mst(p);
+        assert(tree.size() == N-1);
+        for(auto const&e:tree) got.push_back(dist(e.first, e.second));
+        sort(expected.begin(), expected.end());
+        assert(got == expected);
+        const vector<int> nearest = nearest_neighbors(p);
+        for(size_t i=0;i<N;++i){
+            assert(nearest[i] >= 0 && nearest[i] != static_cast<int>(i));
+            for(size_t j=0;j<N;++j){
+                assert(i == j || dist(i, nearest[i]) <= dist(i, j));
+            }
+        }
+        cerr << "Test ok\n";
+    }
+    void test_delaunay_graphs(){
+        test_delaunay_graphs_impl<30>(500, (1<<29)-1);
+        test_delaunay_graphs_impl<30>(500, 15);
+        test_delaunay_graphs_impl<30>(100, 1000, true);
+        test_delaunay_graphs_impl<62>(300, (int64_t{1}<<61)-1);
+    }
+    /// Voronoi vertices are equidistant to their sites and no site is closer, edges are consistent with their ends
+    template<size_t bits>
+    void test_voronoi_impl(size_t N, int64_t lim, bool collinear = false){
+        cerr << "Running test test_voronoi " << bits << " " << N << " " << lim << "\n";
+        mt19937_64 rng(100531);
+        auto get_rand = [&](){return uniform_int_distribution<int64_t>(-lim, lim)(rng);};
+        set<pair<int64_t, int64_t> > distinct;
+        while(distinct.size() < N){
+            const int64_t x = get_rand();
+            distinct.emplace(x, collinear ? x : get_rand());
+        }
+        vector<Point<bits> > p;
+        for(auto const&e:distinct) p.emplace_back(e.first, e.second);
+        shuffle(p.begin(), p.end(), rng);
+        const auto diagram = voronoi_diagram(p);
+        using Diagram = Voronoi_Diagram<bits>;
+        auto dist = [&](auto const&v, size_t site){return (v.p - p[site]*v.w).norm_sq();};
+        vector<int> degree(N, 0);
+        size_t rays = 0;
+        for(auto const&e:diagram.edges){
+            ++degree[e.sites[0]];
+            ++degree[e.sites[1]];
+            rays+= (e.ends[0] == Diagram::NONE) + (e.ends[1] == Diagram::NONE);
+            for(uint32_t v:e.ends){
+                if(v == Diagram::NONE) continue;
+                auto const&vertex = diagram.vertices[v];
+                assert(vertex.w > 0);
+                assert(dist(vertex, e.sites[0]) == dist(vertex, e.sites[1]));
+                for(size_t i=0;i<N;++i){
+                    assert(dist(vertex, i) >= dist(vertex, e.sites[0]));
+                }
+            }
+            if(e.ends[0] != Diagram::NONE && e.ends[1] != Diagram::NONE){
+                auto const&u = diagram.vertices[e.ends[0]], &v = diagram.vertices[e.ends[1]];
+                auto const diff = v.p*u.w - u.p*v.w;
+                assert(diff.cross(e.direction) == 0 && diff.dot(e.direction) >= 0);
+            }
+        }
+        // one ray per hull edge, convex_hull skips collinear points, so only compare for random points
+        if(collinear) assert(rays == 2*diagram.edges.size());
+        else if(lim > 1000) assert(rays == convex_hull(p).size());
+        assert(diagram.cell_begin.size() == N+1);
+        for(size_t i=0;i<N;++i){
+            assert(static_cast<int>(diagram.cell_begin[i+1] - diagram.cell_begin[i]) == degree[i]);
+            for(uint32_t j=diagram.cell_begin[i];j<diagram.cell_begin[i+1];++j){
+                auto const&e = diagram.edges[diagram.cell_edges[j]];
+                assert(e.sites[0] == i || e.sites[1] == i);
+            }
+        }
+        cerr << "Test ok\n";
+    }
+    void test_voronoi(){
+        test_voronoi_impl<30>(300, (1<<29)-1);
+        test_voronoi_impl<30>(300, 15);
+        test_voronoi_impl<30>(50, 1000, true);
+        test_voronoi_impl<62>(200, (int64_t{1}<<61)-1);
+    }
+    /// sort_lexicographical agrees with std::sort, coordinates are scale times a random number in [-lim, lim]
+    template<size_t bits>
+    void test_sort_lexicographical_impl(size_t N, int64_t lim, int64_t scale = 1){
+        cerr << "Running test test_sort_lexicographical " << bits << " " << N << " " << lim << " " << scale << "\n";
+        mt19937_64 rng(N ^ lim);
+        auto get_rand = [&](){
+            const int64_t r = uniform_int_distribution<int64_t>(-lim, lim)(rng);
+            if constexpr(bits <= 63) return Adaptive_Int<bits>(r * scale);
+            else return Adaptive_Int<bits>(Adaptive_Int<62>(r) * Adaptive_Int<bits-63>(scale));
+        };
+        for(int it=0;it<10;++it){
+            vector<Point<bits> > p;
+            for(size_t i=0;i<N;++i){
+                p.emplace_back(get_rand(), get_rand());
+            }
+            auto expected = p;
+            std::sort(expected.begin(), expected.end(), [](Point<bits> const&a, Point<bits> const&b){return a.comp_lexicographical(b) < 0;});
+            sort_lexicographical(p);
+            assert(p == expected);
+        }
+        // the keys are never read from moved-from elements
+        if constexpr(bits <= 62){
+            vector<unique_ptr<Point<bits> > > q;
+            for(size_t i=0;i<N;++i){
+                q.push_back(make_unique<Point<bits> >(get_rand(), get_rand()));
+            }
+            vector<Point<bits> > expected;
+            for(auto const&e:q) expected.push_back(*e);
+            std::sort(expected.begin(), expected.end(), [](Point<bits> const&a, Point<bits> const&b){return a.comp_lexicographical(b) < 0;});
+            radix_sort_lexicographical(q.begin(), q.end(), [](unique_ptr<Point<bits> > const&e) -> Point<bits> const& {return *e;});
+            for(size_t i=0;i<N;++i) assert(*q[i] == expected[i]);
+        }
+        cerr << "Test ok\n";
+    }
+    void test_sort_lexicographical(){
+        test_sort_lexicographical_impl<30>(1000, (1<<29)-1);
+        test_sort_lexicographical_impl<30>(5000, 3);
+        test_sort_lexicographical_impl<30>(100, 1000);
+        test_sort_lexicographical_impl<62>(1000, (int64_t{1}<<61)-1);
+        test_sort_lexicographical_impl<62>(5000, 1000, int64_t{1}<<40);
+        test_sort_lexicographical_impl<126>(1000, (int64_t{1}<<61)-1, int64_t{1}<<40);
+        test_sort_lexicographical_impl<126>(1000, 1000, int64_t{1}<<40);
+        test_sort_lexicographical_impl<200>(1000, 1000, int64_t{1}<<40);
+    }
+    /// the parallel, the filtered and the batched hulls equal the sequential one, also with duplicates and collinear points
+    template<size_t bits>
+    void test_convex_hull_parallel_impl(size_t N, int64_t lim, bool collinear = false){
+        cerr << "Running test test_convex_hull_parallel " << bits << " " << N << " " << lim << "\n";
+        mt19937_64 rng(100531);
+        auto get_rand = [&](){return uniform_int_distribution<int64_t>(-lim, lim)(rng);};
+        Convex_Hull_Workspace<bits> ws;
+        vector<Point<bits> > hulls;
+        vector<size_t> begin, hull_begin;
+        for(int it=0;it<20;++it){
+            vector<Point<bits> > p;
+            for(size_t i=0;i<N;++i){
+                const int64_t x = get_rand();
+                p.emplace_back(x, collinear ? -x : get_rand());
+            }
+            const auto expected = convex_hull(p);
+            assert(convex_hull(p, Hull_Octagon_Filter{}) == expected);
+            for(size_t thread_cnt:{2, 3, 8}){
+                assert(convex_hull_parallel(p, thread_cnt) == expected);
+                assert(convex_hull_parallel(p, thread_cnt, Hull_Octagon_Filter{}) == expected);
+            }
+            vector<Point<bits> > out(expected.size());
+            assert(convex_hull(p.begin(), p.end(), out.begin(), ws) == out.end() && out == expected);
+            // chunks of random sizes, some of them empty
+            begin.assign(1, 0);
+            while(begin.back() < N) begin.push_back(min<size_t>(N, begin.back() + rng() % 20));
+            convex_hulls(p, begin, hulls, hull_begin, ws, Hull_Octagon_Filter{});
+            assert(hull_begin.size() == begin.size());
+            for(size_t i=0;i+1<begin.size();++i){
+                const auto chunk = convex_hull(vector<Point<bits> >(p.begin() + begin[i], p.begin() + begin[i+1]));
+                assert(vector<Point<bits> >(hulls.begin() + hull_begin[i], hulls.begin() + hull_begin[i+1]) == chunk);
+            }
+        }
+        cerr << "Test ok\n";
+    }
+    void test_convex_hull_parallel(){
+        test_convex_hull_parallel_impl<30>(1000, (1<<29)-1);
+        test_convex_hull_parallel_impl<30>(1000, 3);
+        test_convex_hull_parallel_impl<30>(100, 1000, true);
+        test_convex_hull_parallel_impl<62>(1000, (int64_t{1}<<61)-1);
+        test_convex_hull_parallel_impl<30>(5, 10);
+    }
+    /// random insertions and deletions, the hull and the queries are compared to brute force
+    template<size_t bits>
+    void test_dynamic_hull_impl(size_t N, int64_t lim, int ops, bool collinear = false){
+        cerr << "Running test test_dynamic_hull " << bits << " " << N << " " << lim << "\n";
+        mt19937_64 rng(100531);
+        auto get_rand = [&](){return uniform_int_distribution<int64_t>(-lim, lim)(rng);};
+        auto get_point = [&](){
+            const int64_t x = get_rand();
+            return Point<bits>(x, collinear ? 2*x : get_rand());
+        };
+        Dynamic_Hull<bits> h;
+        vector<Point<bits> > p;
+        for(int op=0;op<ops;++op){
+            if(p.size() < N && (p.empty() || rng()%3)){
+                const auto q = get_point();
+                const bool present = find(p.begin(), p.end(), q) != p.end();
+                assert(h.insert(q) == !present);
+                if(!present) p.push_back(q);
+            } else {
+                const size_t i = rng() % p.size();
+                const auto q = rng()%4 ? p[i] : get_point();
+                const auto it = find(p.begin(), p.end(), q);
+                assert(h.erase(q) == (it != p.end()));
+                if(it != p.end()) p.erase(it);
+            }
+            assert(h.size() == p.size());
+            const auto hull = convex_hull(p);
+            assert(h.get_hull() == hull);
+            if(p.empty()) continue;
+            for(int it=0;it<5;++it){
+                const auto c = rng()%2 ? get_point() : Point<bits>(get_rand(), get_rand());
+                int expected = hull.size() >= 3 ? 1 : -1;
+                if(hull.size() == 1) expected = c == hull[0] ? 0 : -1;
+                else if(hull.size() == 2 && !ccw(hull[0], hull[1], c) && hull[0].comp_lexicographical(c) <= 0 && c.comp_lexicographical(hull[1]) <= 0) expected = 0;
+                for(size_t i=0;hull.size() >= 3 && i<hull.size();++i){
+                    const int s = ccw(hull[i], hull[(i+1)%hull.size()], c);
+                    if(s < 0) expected = -1;
+                    if(s == 0 && expected > 0) expected = 0;
+                }
+                assert(h.contains(c) == expected);
+                const Point<bits> dir(get_rand(), get_rand());
+                if(dir.x != 0 || dir.y != 0){
+                    const auto e = h.extreme_point(dir);
+                    assert(find(p.begin(), p.end(), e) != p.end());
+                    for(auto const&q:p) assert(dir.dot(q) <= dir.dot(e));
+                }
+                if(expected < 0){
+                    const auto [t, u] = h.tangents(c);
+                    assert(find(p.begin(), p.end(), t) != p.end() && find(p.begin(), p.end(), u) != p.end());
+                    for(auto const&q:p) assert(ccw(c, t, q) >= 0 && ccw(c, u, q) <= 0);
+                }
+            }
+        }
+        cerr << "Test ok\n";
+    }
+    void test_dynamic_hull(){
+        test_dynamic_hull_impl<30>(10, 3, 2000);
+        test_dynamic_hull_impl<30>(200, 1000, 2000);
+        test_dynamic_hull_impl<30>(30, 1000, 1000, true);
+        test_dynamic_hull_impl<62>(300, (int64_t{1}<<61)-1, 2000);
+        test_dynamic_hull_impl<62>(100, 4, 2000);
+    }
+    /// streamed hulls from memory, a binary stream and a file equal convex_hull, also if the hull is larger than a chunk
+    template<size_t bits>
+    void test_streaming_hull_impl(size_t N, int64_t lim, bool parabola = false){
+        cerr << "Running test test_streaming_hull " << bits << " " << N << " " << lim << "\n";
+        mt19937_64 rng(100531);
+        auto get_rand = [&](){return uniform_int_distribution<int64_t>(-lim, lim)(rng);};
+        vector<Point<bits> > p;
+        for(size_t i=0;i<N;++i){
+            const int64_t x = get_rand();
+            // points on a parabola are all on the hull
+            p.emplace_back(x, parabola ? x*x : get_rand());
+        }
+        const auto expected = convex_hull(p);
+        stringstream records;
+        records.write(reinterpret_cast<char const*>(p.data()), p.size() * sizeof(Point<bits>));
+        for(size_t chunk_size:{1, 7, 100, 100000}){
+            Streaming_Hull<bits> h(chunk_size);
+            h.add(p.begin(), p.begin() + N/2);
+            assert(h.get_hull() == convex_hull(vector<Point<bits> >(p.begin(), p.begin() + N/2)));
+            h.add(p.begin() + N/2, p.end());
+            assert(h.get_hull() == expected);
+            records.clear();
+            records.seekg(0);
+            const auto got = convex_hull_stream<bits, Hull_No_Filter>(records, chunk_size);
+            assert(got && *got == expected);
+        }
+        // a truncated last record is reported
+        stringstream truncated;
+        truncated.write(reinterpret_cast<char const*>(p.data()), p.size() * sizeof(Point<bits>) - 1);
+        assert(!convex_hull_stream<bits>(truncated, 7));
+        // so is a read error after a whole number of records
+        struct Failing_Buffer : streambuf{
+            vector<char> data;
+            bool served = false;
+            int_type underflow() override {
+                if(served) throw runtime_error("read error");
+                served = true;
+                setg(data.data(), data.data(), data.data() + data.size());
+                return traits_type::to_int_type(*gptr());
+            }
+        } failing;
+        failing.data.assign(reinterpret_cast<char const*>(p.data()), reinterpret_cast<char const*>(p.data() + 4));
+        istream failing_in(&failing);
+        assert(!convex_hull_stream<bits>(failing_in, 7) && failing_in.bad());
+        #ifdef DACIN_HAS_POSIX_READ
+        FILE* file = tmpfile();
+        assert(file);
+        fwrite(p.data(), sizeof(Point<bits>), p.size(), file);
+        fflush(file);
+        rewind(file);
+        const auto got = convex_hull_stream<bits>(fileno(file), 13);
+        assert(got && *got == expected);
+        fputc(0, file);
+        fflush(file);
+        rewind(file);
+        assert(!convex_hull_stream<bits>(fileno(file), 13));
+        fclose(file);
+        #endif // DACIN_HAS_POSIX_READ
+        cerr << "Test ok\n";
+    }
+    void test_streaming_hull(){
+        test_streaming_hull_impl<30>(10000, (1<<29)-1);
+        test_streaming_hull_impl<30>(10000, 5);
+        test_streaming_hull_impl<30>(3000, 10000, true);
+        test_streaming_hull_impl<62>(10000, (int64_t{1}<<61)-1);
+        test_streaming_hull_impl<126>(3000, (int64_t{1}<<61)-1);
+    }
+    /// antipodal pairs, diameter, width and bounding rectangles against brute force over all edges and vertices
+    template<size_t bits>
+    void test_rotating_calipers_impl(size_t N, int64_t lim){
+        cerr << "Running test test_rotating_calipers " << bits << " " << N << " " << lim << "\n";
+        mt19937_64 rng(100531);
+        auto get_rand = [&](){return uniform_int_distribution<int64_t>(-lim, lim)(rng);};
+        for(int it=0;it<300;++it){
+            vector<Point<bits> > p(1 + rng() % N);
+            for(auto &e:p) e = Point<bits>(get_rand(), get_rand());
+            const auto hull = convex_hull(p);
+            const size_t h = hull.size();
+            // two vertices are antipodal iff they are extreme in opposite directions for some edge normal
+            set<pair<size_t, size_t> > expected;
+            for(size_t i=0;i<h;++i){
+                auto const e = hull[(i+1)%h] - hull[i];
+                const Point<bits+1> normal(e.y, -e.x);
+                auto const hi = normal.dot(*max_element(hull.begin(), hull.end(), [&](auto const&a, auto const&b){return normal.dot(a) < normal.dot(b);}));
+                auto const lo = normal.dot(*min_element(hull.begin(), hull.end(), [&](auto const&a, auto const&b){return normal.dot(a) < normal.dot(b);}));
+                for(size_t a=0;a<h;++a){
+                    for(size_t b=0;b<h;++b){
+                        if(a != b && normal.dot(hull[a]) == hi && normal.dot(hull[b]) == lo) expected.emplace(min(a, b), max(a, b));
+                    }
+                }
+            }
+            if(h <= 2) expected = {{0, h-1}};
+            set<pair<size_t, size_t> > got;
+            for(auto const&e:antipodal_pairs(hull)) assert(got.emplace(min(e[0], e[1]), max(e[0], e[1])).second);
+            assert(got == expected);
+            auto max_dist = (hull[0] - hull[0]).norm_sq();
+            for(auto const&a:hull) for(auto const&b:hull) max_dist = max(max_dist, (a - b).norm_sq());
+            const auto d = diameter(hull);
+            assert(d.first == max_dist && (hull[d.second[0]] - hull[d.second[1]]).norm_sq() == max_dist);
+            if(h < 2) continue;
+            // the brute force rectangles on each edge
+            size_t cnt = 0;
+            rotating_calipers(hull, [&](Calipers_Rectangle const&r){
+                assert(r.edge == cnt++);
+                auto const e = hull[(r.edge+1)%h] - hull[r.edge];
+                for(auto const&q:hull){
+                    assert(e.cross(q - hull[r.edge]) <= e.cross(hull[r.top] - hull[r.edge]));
+                    assert(e.dot(q) <= e.dot(hull[r.right]) && e.dot(q) >= e.dot(hull[r.left]));
+                }
+            });
+            assert(cnt == h);
+            const auto w = width_sq(hull);
+            const auto area = min_area_rectangle(hull);
+            const auto perimeter = min_perimeter_rectangle(hull);
+            rotating_calipers(hull, [&](Calipers_Rectangle const&r){
+                auto const e = hull[(r.edge+1)%h] - hull[r.edge];
+                auto const height = e.cross(hull[r.top] - hull[r.edge]), length = e.dot(hull[r.right] - hull[r.left]);
+                assert(make_fraction(height * height, e.norm_sq()).comp(w.first) >= 0);
+                assert(make_fraction(height * length, e.norm_sq()).comp(area.first) >= 0);
+                auto const half = height + length;
+                assert(make_fraction((half + half) * (half + half), e.norm_sq()).comp(perimeter.first) >= 0);
+                if(r.edge == w.second[0]) assert(r.top == w.second[1] && make_fraction(height * height, e.norm_sq()).comp(w.first) == 0);
+            });
+        }
+        cerr << "Test ok\n";
+    }
+    void test_rotating_calipers(){
+        test_rotating_calipers_impl<30>(100, (1<<29)-1);
+        test_rotating_calipers_impl<30>(30, 3);
+        test_rotating_calipers_impl<30>(5, 2);
+        test_rotating_calipers_impl<62>(100, (int64_t{1}<<61)-1);
+    }
+    /// divide and conquer gives the same triangles as the incremental algorithm, for any thread count
+    template<size_t bits>
+    void test_delaunay_divide_conquer_impl(size_t N, int64_t lim){
+        cerr << "Running test test_delaunay_divide_conquer " << bits << " " << N << " " << lim << "\n";
+        mt19937_64 rng(100531);
+        auto get_rand = [&](){return uniform_int_distribution<int64_t>(-lim, lim)(rng);};
+        set<pair<int64_t, int64_t> > distinct;
+        while(distinct.size() < N) distinct.emplace(get_rand(), get_rand());
+        vector<Point<bits> > p;
+        for(auto const&e:distinct) p.emplace_back(e.first, e.second);
+        shuffle(p.begin(), p.end(), rng);
+        const auto expected = canonical_triangles(Delaunay<bits>().triangulate_mesh(p));
+        for(size_t thread_cnt:{1, 2, 3, 8}){
+            const Delaunay_Mesh mesh = Delaunay_Divide_Conquer<bits>().triangulate(p, thread_cnt);
+            // cocircular points have more than one triangulation
+            if(lim > 1000) assert(canonical_triangles(mesh) == expected);
+            else check_delaunay_mesh(p, mesh);
+        }
+        cerr << "Test ok\n";
+    }
+    void test_delaunay_divide_conquer(){
+        test_delaunay_divide_conquer_impl<30>(500, (1<<29)-1);
+        test_delaunay_divide_conquer_impl<30>(500, 15);
+        test_delaunay_divide_conquer_impl<62>(20000, (int64_t{1}<<61)-1);
+        test_delaunay_divide_conquer_impl<30>(1500, 40);
+    }
+
+    template<size_t k, size_t n, size_t m, typename limb_t>
+    void test_karatsuba_impl(){
+        cerr << "Running test test_karatsuba " << k << " " << n << " " << m << " " << 8*sizeof(limb_t) << "\n";
+        using Big = Bigint_Fixedsize_Signed<k, limb_t>;
+        mt19937_64 rng(100531);
+        // all ones and zero words for the carry chains
+        auto get_rand = [&](){
+            const int type = uniform_int_distribution<int>(0, 3)(rng);
+            return type == 0 ? limb_t{0} : type == 1 ? ~limb_t{0} : static_cast<limb_t>(rng());
+        };
+        const int ITER = 2000;
+        for(int it=0;it<ITER;++it){
+            array<limb_t, n> a;
+            array<limb_t, m> b;
+            for(auto &e:a) e = get_rand();
+            for(auto &e:b) e = get_rand();
+            array<limb_t, k> expected, got;
+            Big::mul_unsigned(expected, a, b, Mul_Schoolbook{});
+            Big::mul_unsigned(got, a, b, Mul_Karatsuba{});
+            assert(got == expected);
+        }
+        cerr << "Test ok\n";
+    }
+    void test_karatsuba(){
+        test_karatsuba_impl<2, 2, 2, uint32_t>();
+        test_karatsuba_impl<6, 3, 3, uint32_t>();
+        test_karatsuba_impl<7, 5, 2, uint32_t>();
+        test_karatsuba_impl<30, 15, 15, uint32_t>();
+        test_karatsuba_impl<33, 40, 17, uint32_t>();
+        #ifdef HAS_INT128
+        test_karatsuba_impl<21, 11, 11, uint64_t>();
+        test_karatsuba_impl<64, 31, 33, uint64_t>();
+        #endif // HAS_INT128
+    }
+    /// reading __int128 behaves like reading long long
+    void test_int128_stream(){
+        cerr << "Running test test_int128_stream\n";
+        #ifdef HAS_INT128
+        const __int128 big = static_cast<__int128>(~static_cast<unsigned __int128>(0) >> 1);
+        for(__int128 v : {__int128{0}, __int128{-7}, __int128{123456789} * 1000000000 * 1000000000, big, -big-1}){
+            stringstream ss;
+            ss << v;
+            __int128 got = 1;
+            assert(ss >> got && got == v);
+        }
+        for(string s : {"  +5x", "-0 1", "12 34"}){
+            istringstream in(s), in_ll(s);
+            __int128 got;
+            long long expected;
+            in >> got;
+            in_ll >> expected;
+            assert(in && got == expected && in.tellg() == in_ll.tellg());
+        }
+        for(string s : {"", "   ", "abc", "+", "- 5", "x5"}){
+            istringstream in(s), in_ll(s);
+            __int128 got = 1;
+            long long expected = 1;
+            in_ll >> expected;
+            assert(!(in >> got) && got == expected);
+        }
+        for(string s : {"170141183460469231731687303715884105728", "-170141183460469231731687303715884105729", "999999999999999999999999999999999999999999"}){
+            istringstream in(s);
+            __int128 got;
+            assert(!(in >> got) && (s[0] == '-' ? got == -big-1 : got == big));
+        }
+        #endif // HAS_INT128
+        cerr << "Test ok\n";
+    }
+
 } // namespace dacin::geom
 
 
@@ -99,6 +829,21 @@ void run_tests(){
     cerr << "Running all tests\n";
     //dacin::geom::test_hulls_square();
     dacin::geom::test_circumcircle();
+    dacin::geom::test_ccw_filter();
+    dacin::geom::test_circumcircle_filter();
+    dacin::geom::test_compare_products();
+    dacin::geom::test_sort_lexicographical();
+    dacin::geom::test_convex_hull_parallel();
+    dacin::geom::test_dynamic_hull();
+    dacin::geom::test_streaming_hull();
+    dacin::geom::test_rotating_calipers();
+    dacin::geom::test_delaunay();
+    dacin::geom::test_delaunay_move();
+    dacin::geom::test_delaunay_divide_conquer();
+    dacin::geom::test_delaunay_graphs();
+    dacin::geom::test_voronoi();
+    dacin::geom::test_karatsuba();
+    dacin::geom::test_int128_stream();
 
     cerr << "Done with all tests\n";
 }
@@ -0,0 +1,135 @@
+// Released under GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007, see the LICENSE file.
+// Copyright (C) 2018-2019 Daniel Rutschmann aka. dacin21
+
+#ifndef VORONOI_HPP
+#define VORONOI_HPP
+
+#include "delaunay.hpp"
+
+namespace dacin::geom{
+
+/// the point p / w, w is positive
+template<size_t k, size_t l>
+struct Homogeneous_Point{
+    Point<k> p;
+    Adaptive_Int<l> w;
+};
+template<size_t k, size_t l>
+Homogeneous_Point<k, l> make_homogeneous(Point<k> const&p, Adaptive_Int<l> const&w){
+    return Homogeneous_Point<k, l>{p, w};
+}
+template<size_t k>
+Point<k> make_point(Adaptive_Int<k> const&x, Adaptive_Int<k> const&y){
+    return Point<k>(x, y);
+}
+
+/// exact circumcenter of the counter-clockwise triangle a, b, c
+template<size_t n>
+auto circumcenter(Point<n> const&a, Point<n> const&b, Point<n> const&c){
+    auto const B = b - a, C = c - a;
+    auto const b2 = B.norm_sq(), c2 = C.norm_sq();
+    auto const cross = B.cross(C);
+    auto const w = cross + cross;
+    // solves 2 * (B, C)^T * u = (|B|^2, |C|^2)
+    auto const u = make_point(C.y*b2 - B.y*c2, B.x*c2 - C.x*b2);
+    return make_homogeneous(a*w + u, w);
+}
+
+/**
+ *  Voronoi diagram, the dual of a Delaunay triangulation
+ *  The sites are the vertices of the triangulation.
+ *  Cocircular sites give several equal vertices, joined by edges of length zero.
+ */
+template<size_t n>
+struct Voronoi_Diagram{
+    static constexpr uint32_t NONE = Delaunay_Mesh::NONE;
+    using vertex_t = decltype(circumcenter(declval<Point<n> >(), declval<Point<n> >(), declval<Point<n> >()));
+    struct Edge{
+        /// the sites to the left and to the right, going from ends[0] to ends[1]
+        std::array<uint32_t, 2> sites;
+        /// vertex indices, NONE for ends at infinity, so rays have one and lines have two
+        std::array<uint32_t, 2> ends;
+        /// direction from ends[0] to ends[1], sites[1] - sites[0] rotated by 90 degrees
+        Point<n+1> direction;
+    };
+
+    /// circumcenters of the finite Delaunay triangles
+    std::vector<vertex_t> vertices;
+    std::vector<Edge> edges;
+    /// the edges around site v are cell_edges[cell_begin[v], cell_begin[v+1]) in counter-clockwise order
+    /// Unbounded cells start and end with a ray.
+    std::vector<uint32_t> cell_begin, cell_edges;
+};
+
+/// Voronoi diagram of the vertices of d, in O(n)
+template<size_t n>
+Voronoi_Diagram<n> voronoi_diagram(Delaunay<n> &d){
+    using Face = typename Delaunay<n>::Face;
+    using Diagram = Voronoi_Diagram<n>;
+    auto const&faces = d.get_faces();
+    auto const&p = d.get_points();
+    auto index = [&](Face const*f){
+        return static_cast<size_t>(f - faces.data());
+    };
+    Diagram ret;
+    std::vector<uint32_t> vertex_id(faces.size(), Diagram::NONE);
+    for(size_t i=0;i<faces.size();++i){
+        if(Delaunay<n>::is_infinite(faces[i])) continue;
+        vertex_id[i] = ret.vertices.size();
+        ret.vertices.push_back(circumcenter(faces[i].corners[0], faces[i].corners[1], faces[i].corners[2]));
+    }
+    // edge_id[3*i + j] is the edge dual to the side of faces[i] opposite to corner j
+    std::vector<uint32_t> edge_id(3*faces.size(), Diagram::NONE);
+    std::vector<Face const*> vertex_face(p.size(), nullptr);
+    for(size_t i=0;i<faces.size();++i){
+        Face const&f = faces[i];
+        for(int j=0;j<3;++j){
+            const int a = f.vertices[(j+1)%3], b = f.vertices[(j+2)%3];
+            if(Delaunay<n>::is_infinite(a)) continue;
+            vertex_face[a] = &f;
+            // f is to the left of a -> b, the other face has the edge as b -> a
+            if(Delaunay<n>::is_infinite(b) || a > b) continue;
+            Face const*o = f.adj[j];
+            const int k = std::find(o->adj.begin(), o->adj.end(), &f) - o->adj.begin();
+            edge_id[3*i + j] = edge_id[3*index(o) + k] = ret.edges.size();
+            auto const diff = p[b] - p[a];
+            ret.edges.push_back({{static_cast<uint32_t>(a), static_cast<uint32_t>(b)}, {vertex_id[index(o)], vertex_id[i]}, Point<n+1>(-diff.y, diff.x)});
+        }
+    }
+    // the Delaunay edges around each vertex, starting after the infinite neighbors
+    ret.cell_begin.reserve(p.size() + 1);
+    ret.cell_begin.push_back(0);
+    std::vector<std::pair<int, uint32_t> > around;
+    for(size_t v=0;v<p.size();++v){
+        if(vertex_face[v]){
+            around.clear();
+            Face const*f = vertex_face[v];
+            do{
+                const int i = std::find(f->vertices.begin(), f->vertices.end(), static_cast<int>(v)) - f->vertices.begin();
+                around.emplace_back(f->vertices[(i+1)%3], edge_id[3*index(f) + (i+2)%3]);
+                f = f->adj[(i+1)%3];
+            } while(f != vertex_face[v]);
+            const size_t m = around.size();
+            size_t start = 0;
+            for(size_t i=0;i<m;++i){
+                if(Delaunay<n>::is_infinite(around[i].first) && !Delaunay<n>::is_infinite(around[(i+1)%m].first)) start = (i+1)%m;
+            }
+            for(size_t i=0;i<m;++i){
+                auto const&e = around[(start+i)%m];
+                if(!Delaunay<n>::is_infinite(e.first)) ret.cell_edges.push_back(e.second);
+            }
+        }
+        ret.cell_begin.push_back(ret.cell_edges.size());
+    }
+    return ret;
+}
+template<size_t n>
+Voronoi_Diagram<n> voronoi_diagram(std::vector<Point<n> > const&p){
+    Delaunay<n> d;
+    d.triangulate(p);
+    return voronoi_diagram(d);
+}
+
+} // namespace dacin::geom
+
+#endif // VORONOI_HPP